@@ -3,6 +3,8 @@
 #include "SDL.h"
 
 #include <algorithm>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "SDLUtils.hpp"
@@ -13,14 +15,40 @@
 
 #include "Input.hpp"
 #include "GraphicsObjects.hpp"
+#include "FrameLimiter.hpp"
+#include "InputRecording.hpp"
 
 namespace Framework {
+	// Settings which are chosen when the game is launched, so that they can be compared without recompiling
+	struct LaunchOptions {
+		// Draws each frame on a render thread while the next frame is updated (see RenderThread)
+		bool render_thread = WINDOW::RENDER_THREAD;
+
+		// Runs without showing a window or drawing frames, updating the game as fast as possible with the usual fixed dt
+		// The game chooses what to run (e.g. a simulation with scripted input rather than the menus)
+		bool headless = false;
+
+		// Number of rides simulated in headless mode, and the seed of the first one
+		uint32_t rides = SIMULATION::RIDES;
+		uint32_t seed = SIMULATION::FIRST_SEED;
+
+		// If set, the key presses of every update are saved to this file when the game closes (see InputRecording)
+		std::string record_path;
+
+		// If set, the key presses are played back from this recording instead of being read from the keyboard, and the game closes when it ends
+		// The seed is taken from the recording
+		std::string replay_path;
+
+		// Reads the options from the command line arguments, using the defaults for any which aren't given
+		static LaunchOptions parse(int argc, char* argv[]);
+	};
+
 	class BaseGame {
 	public:
 		BaseGame();
 
 		// Returns true if successful, false if something went wrong.
-		bool run();
+		bool run(const LaunchOptions& options = LaunchOptions());
 
 	protected:
 		// Allows game to execute code before main loop, and after last loop.
@@ -36,6 +64,9 @@ namespace Framework {
 
 		GraphicsObjects graphics_objects;
 
+		// Options the game was launched with
+		LaunchOptions launch_options;
+
 		// Current stage
 		BaseStage* stage = nullptr;
 
@@ -44,18 +75,39 @@ namespace Framework {
 		bool init();
 		void quit();
 
+		// Called with a dt of WINDOW::UPDATE_DT, however long frames take
 		bool update(float dt);
-		void render();
+
+		// alpha is how far between the last two updates to draw things, from 0 to 1
+		void render(float alpha);
 
 		// Main game loop
 		bool main_loop();
 
-		uint32_t last_time = 0;
+		// Used instead of main_loop in headless mode: runs one update, and doesn't draw anything to the window
+		bool headless_loop();
+
+		// Returns false if the window was closed
+		bool handle_events();
+
+		// Key presses being recorded or played back, depending on the launch options
+		InputRecording input_recording;
+
+		// Start of the last frame, used to measure dt
+		FrameLimiter::Clock::time_point last_time;
+
+		FrameLimiter frame_limiter;
+
+		// Time since the last update, which is carried over to the next frame
+		float accumulator = 0.0f;
 
 		// Main game window
 		SDL_Window* window = nullptr;
 
 		// Renderer for window
 		SDL_Renderer* renderer = nullptr;
+
+		// Only created if the game is launched with a render thread
+		std::unique_ptr<RenderThread> render_thread;
 	};
 }
\ No newline at end of file
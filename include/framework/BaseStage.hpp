@@ -17,8 +17,11 @@ namespace Framework {
 		virtual void end();
 
 		// Returns false if the application should close
+		// Updates are run at a fixed rate, so dt is always WINDOW::UPDATE_DT
 		virtual bool update(float dt) = 0;
-		virtual void render() = 0;
+
+		// alpha is how far between the previous update and the latest one to draw things, from 0 to 1
+		virtual void render(float alpha) = 0;
 
 		BaseStage* next();
 
@@ -3,6 +3,7 @@
 // https://github.com/nlohmann/json
 #include <nlohmann/json.hpp>
 
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -12,6 +13,33 @@
 namespace Framework {
 	std::string get_directory_path(std::string filepath);
 
+	// Read-only view of the entire contents of a file, which is memory-mapped rather than copied into memory
+	class MappedFile {
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// Returns false if the file couldn't be opened or mapped (empty files can't be mapped)
+		bool open(std::string filepath);
+		void close();
+
+		const uint8_t* data() const;
+		size_t size() const;
+
+	private:
+		const uint8_t* _data = nullptr;
+		size_t _size = 0;
+
+#ifdef _WIN32
+		// Windows HANDLEs, stored as void* to avoid including windows.h here
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+	};
+
 	namespace JSONHandler {
 		using namespace nlohmann;
 		using namespace nlohmann::detail;
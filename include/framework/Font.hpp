@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "Spritesheet.hpp"
 
@@ -41,8 +42,9 @@ namespace Framework {
 		Font();
 		Font(Spritesheet* spritesheet, uint8_t spacing = 1);
 
-		void render_text(std::string text, vec2 position, Colour colour, AnchorPosition anchor_position = AnchorPosition::CENTER_CENTER);
-		void render_text(std::string text, vec2 position, Colour colour, float scale, AnchorPosition anchor_position = AnchorPosition::CENTER_CENTER);
+		// Takes a view rather than a string, so that text formatted into a buffer can be drawn without allocating
+		void render_text(std::string_view text, vec2 position, Colour colour, AnchorPosition anchor_position = AnchorPosition::CENTER_CENTER);
+		void render_text(std::string_view text, vec2 position, Colour colour, float scale, AnchorPosition anchor_position = AnchorPosition::CENTER_CENTER);
 
 		Rect character_rect(uint8_t c);
 		bool valid_character(uint8_t c);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+namespace Framework {
+	// Keeps frames to a steady rate, accurate to a small fraction of a millisecond
+	// Sleeping can overshoot by a millisecond or more, so it only sleeps until the end of the frame is close, then spins for the rest
+	class FrameLimiter {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		FrameLimiter();
+		FrameLimiter(float frame_time);
+
+		// Waits until frame_time after the end of the last frame
+		// If the frame took too long, the next frame is timed from now instead, so that later frames don't rush to catch up
+		void wait();
+
+	private:
+		void sleep_until(Clock::time_point time);
+
+		// Adds the length of a sleep to the estimate of how long sleeps take
+		void add_sleep_sample(double seconds);
+
+		Clock::duration _frame_time = Clock::duration::zero();
+		Clock::time_point _frame_end;
+
+		// Length of each sleep: as short as possible, so that there's less left to spin for
+		static constexpr std::chrono::milliseconds SLEEP_STEP = std::chrono::milliseconds(1);
+
+		// Running mean and variance (Welford's algorithm) of how long each sleep actually took, in seconds
+		// Sleeping stops once less than the mean plus one standard deviation is left, so that it rarely overshoots
+		double _sleep_estimate = 0.005;
+		double _sleep_mean = 0.005;
+		double _sleep_m2 = 0.0;
+		uint32_t _sleep_count = 1;
+	};
+}
\ No newline at end of file
@@ -1,10 +1,25 @@
 #pragma once
 
+#include <functional>
+
 #include "SDLUtils.hpp"
 
 #include "Colour.hpp"
+#include "Profiler.hpp"
 
 namespace Framework {
+	class RenderQueue;
+	class RenderThread;
+
+	// How much work the renderer did to draw a frame, counted by the render queue
+	struct RenderStatistics {
+		// SDL calls which draw something (changing the render target isn't counted)
+		uint32_t draw_calls = 0;
+
+		// Number of times geometry was drawn with a different texture to the geometry before it
+		uint32_t texture_switches = 0;
+	};
+
 	class Graphics {
 	public:
 		Graphics();
@@ -24,9 +39,35 @@ namespace Framework {
 		void set_renderer(SDL_Renderer* _renderer);
 		SDL_Renderer* get_renderer();
 
+		// If set, everything drawn is recorded in the render queue instead of being drawn straight away (including images)
+		void set_render_queue(RenderQueue* _render_queue);
+		RenderQueue* get_render_queue();
+
+		// If set, the render queue is drawn on the render thread, and the renderer must only be used through run_on_renderer
+		void set_render_thread(RenderThread* _render_thread);
+
+		// Runs the task on the render thread and waits for it to finish, or just runs it if there isn't a render thread
+		// Anything which uses the renderer directly (e.g. creating textures), rather than through the render queue, must go through this
+		void run_on_renderer(const std::function<void()>& task);
+
+		// Draws everything recorded in the render queue so far
+		// Must be called before anything is drawn with SDL directly, so that it's drawn in the right order
+		void flush();
+
+		// Draws everything recorded during the frame, and shows it in the window
+		// With a render thread, this only waits for the previous frame to finish, and the frame is drawn while the next one is being updated
+		void present();
+
+		// Statistics of the last frame presented, or all zeros if nothing is drawn through a render queue
+		RenderStatistics get_render_statistics() const;
+
 	private:
 		void set_colour(const Colour& colour);
 
 		SDL_Renderer* renderer = nullptr;
+		RenderQueue* render_queue = nullptr;
+		RenderThread* render_thread = nullptr;
+
+		RenderStatistics render_statistics;
 	};
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include "Image.hpp"
 #include "Spritesheet.hpp"
+#include "RenderQueue.hpp"
+#include "RenderThread.hpp"
 #include "Font.hpp"
 #include "BaseTransition.hpp"
 #include "Button.hpp"
@@ -16,6 +18,12 @@ namespace Framework {
 		Graphics graphics;
 		Window window;
 
+		// Everything drawn through the graphics is recorded here, and drawn once per frame
+		RenderQueue render_queue;
+
+		// Only used with a render thread: each frame is recorded into one of the queues while the other is drawn
+		RenderQueue back_render_queue;
+
 		std::vector<std::unique_ptr<Image>> image_ptrs;
 		std::vector<Spritesheet> spritesheets;
 		std::vector<Font> fonts;
@@ -24,5 +32,8 @@ namespace Framework {
 		std::vector<Button::ButtonImages> button_image_groups;
 
 		std::string base_path;
+
+		// Directory which the executable is in, where files generated by the build are put
+		std::string executable_path;
 	};
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "Graphics.hpp"
 
 namespace Framework {
+	class RenderQueue;
+
 	class Image {
 	public:
 		enum Flags : uint8_t {
@@ -44,8 +46,14 @@ namespace Framework {
 
 		void fill(const Colour& colour);
 
+		// Makes every pixel fully transparent (only for images created with a size)
+		void clear();
+
 		void set_alpha(uint8_t alpha);
 
+		// Render queue this image is recorded in when rendered, or nullptr if it's drawn immediately
+		RenderQueue* get_render_queue();
+
 		SDL_Texture* get_texture();
 		SDL_Surface* get_surface();
 
@@ -2,6 +2,7 @@
 
 #include "Keys.hpp"
 #include "Mouse.hpp"
+#include "Profiler.hpp"
 
 namespace Framework {
 	class InputHandler {
@@ -13,6 +14,7 @@ namespace Framework {
 		void handle_sdl_event(const SDL_Event& sdl_event);
 
 		void set_key(KeyHandler::Key key, KeyHandler::KeyState key_state);
+		KeyHandler::KeyState get_key(KeyHandler::Key key) const;
 
 		bool is_up(KeyHandler::Key key); // Returns true if STILL_UP or JUST_RELEASED
 		bool is_down(KeyHandler::Key key); // Returns true if STILL_DOWN or JUST_PRESSED
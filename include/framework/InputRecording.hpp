@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Input.hpp"
+
+namespace Framework {
+	// Key states for every update of a run of the game, which can be played back to repeat the run exactly (since updates use a fixed dt)
+	// Only changes are stored, along with the seed the run used, so recordings are small enough to keep alongside benchmark results
+	// The mouse isn't recorded, so it's ignored while a recording is played back
+	class InputRecording {
+	public:
+		InputRecording();
+		InputRecording(uint32_t seed);
+
+		// Called before each update: stores any key states which have changed since the last update
+		void record(const InputHandler& input);
+
+		// Called before each update: sets the key states which changed before this update when it was recorded
+		// Returns false once every recorded update has been played back
+		bool replay(InputHandler& input);
+
+		uint32_t get_seed() const;
+		uint32_t get_update_count() const;
+
+		// Both return false if the file couldn't be written or read
+		bool save(const std::string& filepath) const;
+		bool load(const std::string& filepath);
+
+	private:
+		struct Change {
+			uint32_t update;
+			KeyHandler::Key key;
+			KeyHandler::KeyState state;
+		};
+
+		struct Header {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t seed;
+			uint32_t update_count;
+			uint32_t change_count;
+		};
+
+		static constexpr uint32_t MAGIC = 0x52494D4D; // "MMIR"
+		static constexpr uint32_t VERSION = 1;
+
+		// Each change is stored as the number of updates since the last change (LEB128, so usually one byte), then the key and its state packed into one byte
+		static constexpr uint8_t STATE_BITS = 2;
+		static_assert(KeyHandler::KEY_COUNT << STATE_BITS <= 0x100, "Key and state must fit in one byte");
+
+		uint32_t _seed = 0;
+		uint32_t _update_count = 0;
+
+		std::vector<Change> _changes;
+
+		// Key states which a replay would have at the next update, if nothing changed
+		KeyHandler::KeyUnion _expected_states;
+
+		// Position in the recording while it's played back
+		uint32_t _next_update = 0;
+		size_t _next_change = 0;
+	};
+}
\ No newline at end of file
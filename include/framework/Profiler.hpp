@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+// Profiling is compiled out of release builds, unless PROFILE_RELEASE is defined (e.g. to profile an optimised build)
+#if !defined(NDEBUG) || defined(PROFILE_RELEASE)
+#define PROFILER_ENABLED
+#endif
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+#ifdef PROFILER_ENABLED
+// Times from here to the end of the enclosing scope, adding it to the zone's time for the current frame
+// The zone is registered the first time it's reached, so the name must be a string literal
+#define PROFILE_ZONE(name) \
+	static const uint32_t PROFILER_CONCAT(_profiler_zone_id_, __LINE__) = Framework::Profiler::get().register_zone(name); \
+	Framework::Profiler::Zone PROFILER_CONCAT(_profiler_zone_, __LINE__)(PROFILER_CONCAT(_profiler_zone_id_, __LINE__))
+
+// Called once at the end of every frame
+#define PROFILE_END_FRAME() Framework::Profiler::get().end_frame()
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_END_FRAME()
+#endif
+
+namespace Framework {
+	// Measures how long each frame takes, and how much of it is spent in each zone (a scope marked with PROFILE_ZONE)
+	// Only the last FRAME_HISTORY frames are kept, and nothing is allocated after the profiler is created
+	// Zones can be timed on any thread (e.g. the render thread), but frames must be ended and stats read on the main thread
+	class Profiler {
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		static constexpr uint32_t MAX_ZONES = 16;
+		static constexpr uint32_t FRAME_HISTORY = 240;
+
+		// Returned by register_zone when there are already MAX_ZONES zones, and ignored by Zone
+		static constexpr uint32_t NO_ZONE = MAX_ZONES;
+
+		// Times in milliseconds, over the frames in the history
+		struct Stats {
+			float min = 0.0f;
+			float average = 0.0f;
+			float p99 = 0.0f;
+		};
+
+		class Zone {
+		public:
+			Zone(uint32_t zone_id);
+			~Zone();
+
+			Zone(const Zone&) = delete;
+			Zone& operator=(const Zone&) = delete;
+
+		private:
+			uint32_t _zone_id;
+			Clock::time_point _start;
+		};
+
+		static Profiler& get();
+
+		// Returns the id used to time the zone
+		uint32_t register_zone(const char* name);
+
+		// Stores the frame's times in the history, and starts the next frame
+		void end_frame();
+
+		uint32_t zone_count() const;
+		const char* zone_name(uint32_t zone_id) const;
+
+		Stats frame_stats() const;
+		Stats zone_stats(uint32_t zone_id) const;
+
+		// Number of frames in the history, and the time taken by each of them (oldest first)
+		uint32_t frame_count() const;
+		float frame_time(uint32_t index) const;
+
+		// Prints the stats of the frames and every zone
+		void print_report() const;
+
+	private:
+		Profiler();
+
+		struct Frame {
+			float time = 0.0f;
+			std::array<float, MAX_ZONES> zone_times{};
+		};
+
+		// Frame time (if zone_id is NO_ZONE) or zone time of each frame in the history
+		Stats get_stats(uint32_t zone_id) const;
+
+		std::array<const char*, MAX_ZONES> _zone_names{};
+		std::atomic<uint32_t> _zone_count = 0;
+		std::mutex _register_mutex;
+
+		// Time spent in each zone so far this frame, in nanoseconds
+		std::array<std::atomic<int64_t>, MAX_ZONES> _current_zone_times{};
+		Clock::time_point _frame_start;
+
+		// Ring buffer of the most recent frames
+		std::array<Frame, FRAME_HISTORY> _frames;
+		uint32_t _next_frame = 0;
+		uint32_t _frame_count = 0;
+
+		// Used to find percentiles without allocating
+		mutable std::array<float, FRAME_HISTORY> _sorted_times;
+	};
+}
\ No newline at end of file
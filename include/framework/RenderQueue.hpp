@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Image.hpp"
+#include "SpriteBatch.hpp"
+
+namespace Framework {
+	// Records everything drawn during a frame as commands, rather than drawing it straight away
+	// When submitted, commands are grouped by texture so that each group is drawn by the sprite batch with a single SDL_RenderGeometry call
+	// A command is only moved earlier if it doesn't overlap anything it's moved in front of, so the frame looks the same as if it was drawn in order
+	class RenderQueue {
+	public:
+		RenderQueue();
+		RenderQueue(Graphics* graphics);
+
+		// Same arguments as Image::render, except that the rects must have a size
+		void sprite(Image* image, Rect source_rect, Rect destination_rect, float angle, vec2 centre, ImageFlip flip = ImageFlip::FLIP_NONE);
+
+		// Fills the whole render target
+		void fill(const Colour& colour);
+		void fill(const Rect& rect, const Colour& colour);
+
+		void line(const vec2& start, const vec2& end, const Colour& colour);
+		void rect(const Rect& rect, const Colour& colour);
+		void circle(const vec2& centre, float radius, const Colour& colour);
+
+		// Colour which sprites recorded from now on are multiplied by
+		void set_colour(const Colour& colour);
+
+		// Everything recorded from now on is drawn to the image, or to the window if image is nullptr
+		void set_target(Image* image);
+
+		// Sets every pixel of the render target to the colour, without blending
+		void clear(const Colour& colour);
+
+		// Draws everything recorded so far to the current render target, and empties the queue
+		void submit();
+
+		// Returns what has been drawn by every submit since the last call, and starts counting again
+		RenderStatistics take_statistics();
+
+	private:
+		enum class CommandType : uint8_t {
+			// Textured or untextured rectangle, which can be merged with other quads with the same texture
+			QUAD,
+
+			// Drawn with the SDL draw functions, one call each
+			FILL_TARGET,
+			CLEAR_TARGET,
+			SET_TARGET,
+			LINE,
+			RECT,
+			CIRCLE
+		};
+
+		struct Command {
+			CommandType type;
+
+			// Texture of a quad (nullptr for untextured quads), or the new render target (nullptr for the window)
+			SDL_Texture* texture = nullptr;
+
+			// Corners of a quad
+			std::array<SDL_Vertex, 4> vertices;
+
+			// Colour and shape of anything else: the ends of a line, the position and size of a rect, or a circle's centre and radius
+			SDL_Color colour{};
+			vec2 start;
+			vec2 end;
+			float radius = 0.0f;
+
+			// Area of the render target which the command draws to (inclusive of start, exclusive of end)
+			vec2 bounds_start;
+			vec2 bounds_end;
+		};
+
+		// Commands which are drawn together, in the order they were recorded
+		struct Batch {
+			CommandType type;
+			SDL_Texture* texture = nullptr;
+
+			// Union of the bounds of every command in the batch
+			vec2 bounds_start;
+			vec2 bounds_end;
+
+			// Position of the batch's first command in _order, and number of commands
+			uint32_t first = 0;
+			uint32_t count = 0;
+		};
+
+		// Number of batches searched back through for one with the same texture, so that submitting stays linear in the number of commands
+		static constexpr uint32_t MAX_BATCH_LOOKBACK = 32;
+
+		// Bounds of commands which affect the whole render target, so that nothing is ever moved past them
+		static constexpr vec2 EVERYWHERE = vec2{ std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity() };
+
+		// Shapes are drawn through whole pixels at their edges, with their coordinates truncated, so their bounds are widened to be sure they cover everything drawn
+		static constexpr vec2 SHAPE_MARGIN = vec2{ 2.0f, 2.0f };
+
+		void add_quad(SDL_Texture* texture, const std::array<SDL_Vertex, 4>& vertices);
+		void add_shape(CommandType type, const Colour& colour, const vec2& start, const vec2& end, float radius, const vec2& bounds_start, const vec2& bounds_end);
+
+		void draw_batch(const Batch& batch);
+
+		static bool overlaps(const vec2& a_start, const vec2& a_end, const vec2& b_start, const vec2& b_end);
+
+		Graphics* _graphics = nullptr;
+
+		SDL_Color _colour = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+		// Everything below is kept between frames, so that the queue only allocates while the frames are still growing
+		std::vector<Command> _commands;
+
+		std::vector<Batch> _batches;
+
+		// Batch which each command was added to
+		std::vector<uint32_t> _command_batches;
+
+		// Indices of the commands, sorted by batch
+		std::vector<uint32_t> _order;
+
+		// Draws each batch of quads
+		SpriteBatch _sprite_batch;
+
+		RenderStatistics _statistics;
+
+		// Texture of the last geometry drawn during the current submit
+		SDL_Texture* _last_texture = nullptr;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "SDL.h"
+
+#include "Profiler.hpp"
+#include "RenderQueue.hpp"
+
+namespace Framework {
+	// Draws and presents each frame on its own thread, so that the main thread can update the next frame at the same time
+	// Frames are recorded into one render queue while the other is drawn, so the render thread is never more than one frame behind
+	// SDL renderers can only be used by one thread, so anything else which uses the renderer has to go through run() (see Graphics::run_on_renderer)
+	// Not every platform supports rendering away from the main thread (e.g. macOS), which is why it's optional
+	class RenderThread {
+	public:
+		// spare_queue is the queue which the frame after the first one is recorded into
+		RenderThread(Graphics* graphics, SDL_Window* window, RenderQueue* spare_queue);
+
+		// Waits for the last frame to be presented
+		~RenderThread();
+
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+
+		// Hands over a recorded frame to be drawn and presented, once the previous frame has been presented
+		// Returns the queue which the next frame should be recorded into
+		RenderQueue* present(RenderQueue* frame);
+
+		// Runs the task on the render thread once the current frame has been presented, and waits for it to finish
+		// If called from the render thread, the task is run straight away
+		void run(const std::function<void()>& task);
+
+	private:
+		void loop();
+
+		// Waits until the render thread has nothing to do (lock must be holding _mutex)
+		void wait_until_idle(std::unique_lock<std::mutex>& lock);
+
+		Graphics* _graphics = nullptr;
+		SDL_Window* _window = nullptr;
+
+		// Queue which is handed back by the next call to present()
+		RenderQueue* _free_queue = nullptr;
+
+		// Frame or task for the render thread, which is reset once it's done
+		RenderQueue* _frame = nullptr;
+		const std::function<void()>* _task = nullptr;
+
+		bool _stopping = false;
+
+		std::mutex _mutex;
+
+		// Signalled when there's a frame or task for the render thread
+		std::condition_variable _work_ready;
+
+		// Signalled when the render thread has finished a frame or task
+		std::condition_variable _work_done;
+
+		// Last, so that everything it uses is set up before it starts
+		std::thread _thread;
+	};
+}
\ No newline at end of file
@@ -13,7 +13,8 @@
 namespace Framework::SDLUtils {
 
 	// Initialises necessary SDL bits, and assigns window and renderer.
-	bool init_sdl(SDL_Window*& window, SDL_Renderer*& renderer, const std::string& title, const vec2& size);
+	// If headless, SDL's dummy video driver is used, so the window is never shown and the renderer is a software renderer
+	bool init_sdl(SDL_Window*& window, SDL_Renderer*& renderer, const std::string& title, const vec2& size, bool headless = false);
 
 	std::string find_base_directory(std::string test_file, uint8_t depth);
 
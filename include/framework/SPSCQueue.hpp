@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <optional>
+
+namespace Framework {
+	// Lock-free queue for handing items from one thread (the producer) to another (the consumer)
+	// Each end must only ever be used by one thread
+	template <typename T, uint32_t Capacity>
+	class SPSCQueue {
+		// Counters wrap around, so the capacity has to divide evenly into 2^32
+		static_assert(std::has_single_bit(Capacity), "SPSCQueue capacity must be a power of two");
+
+	public:
+		// Producer only: item is only moved from if there was room for it
+		bool push(T&& item) {
+			uint32_t tail = _tail.load(std::memory_order_relaxed);
+			if (tail - _head.load(std::memory_order_acquire) == Capacity) return false;
+
+			_items[tail % Capacity] = std::move(item);
+
+			// Publishes the item to the consumer
+			_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer only: empty if there was nothing in the queue
+		std::optional<T> pop() {
+			uint32_t head = _head.load(std::memory_order_relaxed);
+			if (head == _tail.load(std::memory_order_acquire)) return {};
+
+			T item = std::move(_items[head % Capacity]);
+
+			// Hands the slot back to the producer
+			_head.store(head + 1, std::memory_order_release);
+			return item;
+		}
+
+	private:
+		std::array<T, Capacity> _items{};
+
+		// Both only ever increase (wrapping around is fine, since only the difference is used)
+		// Kept on separate cache lines, so that each thread only writes to its own
+		alignas(64) std::atomic<uint32_t> _head = 0;
+		alignas(64) std::atomic<uint32_t> _tail = 0;
+	};
+}
\ No newline at end of file
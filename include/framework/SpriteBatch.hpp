@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Image.hpp"
+
+namespace Framework {
+	// Collects quads drawn with the same texture, and draws them all with a single call
+	// The batch is drawn as soon as a quad with a different texture is added, so quads are always drawn in the order they were added
+	// RenderQueue sorts what it records into batches, and draws each one through a SpriteBatch
+	class SpriteBatch {
+	public:
+		SpriteBatch();
+		SpriteBatch(Graphics* graphics);
+
+		// Same arguments as Image::render, except that the rects must have a size
+		void add(Image* image, Rect source_rect, Rect destination_rect, float angle, vec2 centre, ImageFlip flip = ImageFlip::FLIP_NONE);
+
+		// Adds a quad whose corners have already been worked out (texture is nullptr for an untextured quad)
+		void add_quad(SDL_Texture* texture, const std::array<SDL_Vertex, 4>& vertices);
+
+		// Colour which sprites added from now on are multiplied by
+		void set_colour(const Colour& colour);
+
+		// Draws everything in the batch, and empties it
+		// Returns false if the batch was already empty, so nothing was drawn
+		bool flush();
+
+		// Corners of a sprite, rounded and rotated the same way as Image::render
+		static std::array<SDL_Vertex, 4> get_sprite_vertices(Image* image, Rect source_rect, Rect destination_rect, float angle, vec2 centre, ImageFlip flip, SDL_Color colour);
+
+	private:
+		Graphics* _graphics = nullptr;
+
+		// Texture which every quad in the batch uses
+		SDL_Texture* _texture = nullptr;
+
+		SDL_Color _colour = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+		// Kept between batches, so that they only allocate while the batches are still growing
+		std::vector<SDL_Vertex> _vertices;
+		std::vector<int> _indices;
+	};
+}
\ No newline at end of file
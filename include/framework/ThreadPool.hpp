@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Framework {
+	class ThreadPool {
+	public:
+		// If thread_count is 0, one thread is created per core, leaving one core free for the main thread
+		ThreadPool(uint32_t thread_count = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		uint32_t thread_count();
+
+		// Tasks are passed the index of the thread running them, so that each thread can have its own resources without locking
+		// Tasks which haven't started when the pool is destroyed are discarded
+		template <typename T>
+		std::future<T> submit(std::function<T(uint32_t)> task) {
+			std::shared_ptr<std::packaged_task<T(uint32_t)>> packaged_task = std::make_shared<std::packaged_task<T(uint32_t)>>(std::move(task));
+			std::future<T> result = packaged_task->get_future();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_tasks.emplace([packaged_task](uint32_t thread_index) { (*packaged_task)(thread_index); });
+			}
+			_condition.notify_one();
+
+			return result;
+		}
+
+	private:
+		void run(uint32_t thread_index);
+
+		std::vector<std::thread> _threads;
+		std::queue<std::function<void(uint32_t)>> _tasks;
+
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		bool _stopping = false;
+	};
+}
\ No newline at end of file
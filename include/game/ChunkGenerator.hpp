@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Constants.hpp"
+#include "Random.hpp"
+#include "WaveFunctionCollapse.hpp"
+
+#ifdef COMPILED_TERRAIN_RULES
+// Generated at build time by the rule compiler
+#include "CompiledTerrainRules.hpp"
+typedef CompiledTerrainRules TerrainRules;
+#else
+typedef WFC::RuleSet TerrainRules;
+#endif
+
+// Generates the terrain for each chunk of the level
+// Doesn't depend on any graphics, so can also be used without the game (e.g. for benchmarking)
+class ChunkGenerator {
+public:
+	enum class RailDirection {
+		NONE,
+		UP,
+		DOWN
+	};
+
+	typedef BasicWaveFunctionCollapse<TerrainRules> TerrainSolver;
+
+	typedef std::array<uint32_t, GAME::CHUNK_TILE_HEIGHT> ChunkColumn;
+	typedef std::array<ChunkColumn, GAME::CHUNK_TILE_WIDTH> ChunkGrid;
+
+	// Column of tiles shared by two chunks: empty for any tiles which couldn't be solved
+	typedef std::array<std::optional<uint32_t>, GAME::CHUNK_TILE_HEIGHT> SeamColumn;
+
+	typedef std::vector<std::pair<uint8_t, RailDirection>> RailHeights;
+
+	// How much work it took to generate a chunk
+	struct ChunkStatistics {
+		uint32_t attempts = 0;
+
+		// Totals over every attempt
+		TerrainSolver::Statistics solver;
+
+		// False if every attempt failed, in which case the chunk has incomplete cells
+		bool complete = false;
+
+		// The plan's constraints contradict each other before the solver has made any decisions
+		// Every attempt would fail in exactly the same way, so no more are made
+		bool unsolvable = false;
+	};
+
+	struct Chunk {
+		uint32_t chunk_id = 0;
+
+		ChunkGrid chunk_grid;
+		RailHeights rail_heights;
+
+		ChunkStatistics statistics;
+	};
+
+	// Everything a chunk depends on from its neighbours, so that the rest of the chunk can be generated independently
+	struct ChunkPlan {
+		uint32_t chunk_id;
+
+		// Two wider than the chunk, one at each end
+		RailHeights rail_heights;
+
+		// Last column of the previous chunk, and last column of this chunk
+		SeamColumn left_seam, right_seam;
+	};
+
+	ChunkGenerator(TerrainRules _terrain_rules, uint32_t _seed);
+
+	// Loads the rules from the rule pack next to the executable, or else from the level data in base_path, unless the rules have been compiled into the game
+	static TerrainRules load_terrain_rules(std::string base_path, std::string executable_path);
+
+	// Generates the rail path and seam for the next chunk
+	// Each plan depends on the previous one, so this must be done in order (but is much cheaper than generating the chunk)
+	ChunkPlan plan_next_chunk();
+
+	// Safe to call from any thread, as long as each thread has its own solver
+	// The result only depends on the plan and the seed, so the chunk can be generated again at any time
+	Chunk generate_chunk(const ChunkPlan& plan, TerrainSolver& solver) const;
+
+	// Creates a solver which can be used by generate_chunk
+	std::unique_ptr<TerrainSolver> create_terrain_solver() const;
+
+	const TerrainRules& get_terrain_rules() const;
+
+private:
+	// Generates the terrain using the random stream for that attempt (attempt 0 is used for planning)
+	Chunk generate_chunk_attempt(const ChunkPlan& plan, uint32_t attempt, TerrainSolver& solver) const;
+
+	// Places the rail path in the solver, starting from column first_column of the rail path, and stops rails on the bottom row
+	void constrain_terrain(TerrainSolver& solver, const RailHeights& rail_heights, uint8_t first_column, uint8_t column_count) const;
+
+	// Each chunk has its own random streams (see SplitMix), so chunks don't depend on how many numbers other chunks used
+	uint32_t seed;
+
+	const TerrainRules terrain_rules;
+	std::vector<uint32_t> non_rail_options;
+
+	uint32_t next_chunk_id = 0;
+	ChunkPlan last_plan;
+
+	// Only used by plan_next_chunk
+	TerrainSolver seam_solver;
+};
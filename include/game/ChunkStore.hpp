@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+// Fixed-size store for a sliding window of chunks, indexed by chunk_id % Capacity
+// Chunk IDs only ever increase, and only the last few are kept, so this avoids the allocations and lookups of a map
+// Any chunks which are Capacity or more behind the newest chunk must be erased before it is inserted
+template <typename T, uint32_t Capacity>
+class ChunkStore {
+public:
+	bool contains(uint32_t chunk_id) const {
+		const std::optional<Slot>& slot = slots[slot_index(chunk_id)];
+		return slot && slot->chunk_id == chunk_id;
+	}
+
+	// Returns nullptr if the chunk isn't in the store
+	T* find(uint32_t chunk_id) {
+		std::optional<Slot>& slot = slots[slot_index(chunk_id)];
+		return slot && slot->chunk_id == chunk_id ? &slot->value : nullptr;
+	}
+
+	const T* find(uint32_t chunk_id) const {
+		const std::optional<Slot>& slot = slots[slot_index(chunk_id)];
+		return slot && slot->chunk_id == chunk_id ? &slot->value : nullptr;
+	}
+
+	T& at(uint32_t chunk_id) {
+		T* value = find(chunk_id);
+		if (!value) throw std::out_of_range("Chunk " + std::to_string(chunk_id) + " isn't loaded");
+		return *value;
+	}
+
+	const T& at(uint32_t chunk_id) const {
+		const T* value = find(chunk_id);
+		if (!value) throw std::out_of_range("Chunk " + std::to_string(chunk_id) + " isn't loaded");
+		return *value;
+	}
+
+	// Replaces whatever was in the chunk's slot
+	void insert(uint32_t chunk_id, T value) {
+		slots[slot_index(chunk_id)].emplace(chunk_id, std::move(value));
+	}
+
+	// Removes every chunk with an ID less than chunk_id
+	void erase_before(uint32_t chunk_id) {
+		for (std::optional<Slot>& slot : slots) {
+			if (slot && slot->chunk_id < chunk_id) slot.reset();
+		}
+	}
+
+	// Calls func(chunk_id, value) for every chunk in the store (not necessarily in order)
+	template <typename F>
+	void for_each(F func) const {
+		for (const std::optional<Slot>& slot : slots) {
+			if (slot) func(slot->chunk_id, slot->value);
+		}
+	}
+
+	// Number of chunks in the store
+	uint32_t size() const {
+		uint32_t count = 0;
+		for (const std::optional<Slot>& slot : slots) {
+			if (slot) count++;
+		}
+		return count;
+	}
+
+	static constexpr uint32_t capacity() { return Capacity; }
+
+	// Index of the slot the chunk is stored in, so that other per-chunk data can be kept alongside the store
+	static constexpr uint32_t slot_index(uint32_t chunk_id) { return chunk_id % Capacity; }
+
+private:
+	struct Slot {
+		uint32_t chunk_id;
+		T value;
+	};
+
+	std::array<std::optional<Slot>, Capacity> slots{};
+};
@@ -17,7 +17,39 @@ namespace WINDOW {
 	constexpr float TARGET_FPS = 120.0f;
 	constexpr float TARGET_DT = 1.0f / TARGET_FPS;
 
+	// Game logic is updated at a fixed rate, so that the physics behaves the same whatever the frame rate
+	// Rendering interpolates between the last two updates, so movement is still smooth when more frames are drawn than updates
+	constexpr float UPDATE_RATE = 120.0f;
+	constexpr float UPDATE_DT = 1.0f / UPDATE_RATE;
+
+	// Longest time a single frame can add to the simulation, so that a long frame can't cause a long series of catch-up updates
 	constexpr float MAX_DT = 0.05f;
+
+	// Draws each frame on a separate thread while the next frame is updated
+	// Can also be chosen when the game is launched, with --render-thread or --single-thread
+	constexpr bool RENDER_THREAD = false;
+}
+
+namespace SIMULATION {
+	// Number of rides simulated in headless mode (--headless), each using the seed after the last one
+	constexpr uint32_t RIDES = 100;
+	constexpr uint32_t FIRST_SEED = 0;
+
+	// Longest ride, in seconds of game time (rides also end if the player falls off the rails)
+	constexpr float RIDE_TIME = 60.0f;
+
+	// Scripted input: RIGHT is held for ACCELERATE_TIME, then released for COAST_TIME, over and over
+	constexpr float ACCELERATE_TIME = 4.0f;
+	constexpr float COAST_TIME = 2.0f;
+}
+
+namespace DEBUG {
+	// Draws the outline of each chunk of the level
+	constexpr bool SHOW_CHUNK_OUTLINES = false;
+
+	// Prints each chunk's generation attempts and how the solver finished
+	// Chunks are generated on several threads at once, so this is only useful for debugging a single chunk
+	constexpr bool LOG_GENERATION = false;
 }
 
 namespace STRINGS {
@@ -56,6 +88,10 @@ namespace PATHS {
 		const std::string LOCATION = "assets/levels/";
 
 		const std::string TERRAIN_GENERATION_DATA = "terrain_generation.json";
+
+		// Compiled from TERRAIN_GENERATION_DATA by the rule compiler, and used instead of it if present
+		const std::string TERRAIN_GENERATION_RULE_PACK = "terrain_generation.rules";
+		const std::string RULE_PACK_EXTENSION = ".rules";
 	}
 }
 
@@ -128,6 +164,26 @@ namespace COLOURS {
 	const Framework::Colour GREY { 0x6B, 0x7A, 0x99 };
 	const Framework::Colour BLUE { 0xA7, 0xC7, 0xE7 };
 	const Framework::Colour WHITE { 0xFF, 0xFF, 0xFF };
+	const Framework::Colour RED { 0xE0, 0x5A, 0x5A };
+}
+
+namespace OVERLAY {
+	// Performance overlay, toggled in game with O
+	constexpr float TEXT_SCALE = 1.0f;
+	constexpr float LINE_HEIGHT = 18.0f;
+	constexpr float PADDING = 8.0f;
+	constexpr float WIDTH = 496.0f;
+
+	constexpr uint8_t BACKGROUND_ALPHA = 0xC0;
+
+	// Frame time graph, where frames slower than the target frame rate are drawn in red
+	constexpr float GRAPH_HEIGHT = 64.0f;
+
+	// Frame time at the top of the graph: twice the target frame time, in milliseconds
+	constexpr float GRAPH_MAX_TIME = 2000.0f * WINDOW::TARGET_DT;
+
+	// Longest line, including the null terminator
+	constexpr uint32_t MAX_LINE_LENGTH = 64;
 }
 
 namespace TIMINGS {
@@ -193,10 +249,45 @@ namespace GAME {
 	constexpr uint32_t CHUNK_HEIGHT = CHUNK_TILE_HEIGHT * SPRITES::SIZE;
 	constexpr uint32_t CHUNK_WIDTH = CHUNK_TILE_WIDTH * SPRITES::SIZE;
 
+	// Most chunks which can be loaded at once: enough for the screen plus the chunks generated ahead of it
+	constexpr uint32_t MAX_LOADED_CHUNKS = 16;
+
+	// Chunks generated ahead of the right edge of the screen, even when the player isn't moving
+	// At least one chunk per worker is always generated ahead, to keep them all busy
+	constexpr uint32_t MIN_LOOKAHEAD_CHUNKS = 1;
+
+	// Seconds of travel at the player's current speed which are generated ahead on top of MIN_LOOKAHEAD_CHUNKS
+	// Should be longer than it takes to generate a chunk, so that the player can't outrun the generation
+	constexpr float LOOKAHEAD_TIME = 1.0f;
+
+	// The last column of each chunk (the seam) is solved before the rest of the chunk, so that chunks can be generated in parallel
+	// Solving it with a few columns either side makes it much more likely that the rest of the chunk can be joined to it
+	constexpr uint32_t SEAM_SOLVE_WIDTH = 5;
 
 	constexpr uint32_t MAX_COLLAPSE_ATTEMPTS = 1000;
+
+	// Number of times the seam solver starts again from the beginning before giving up
 	constexpr uint32_t MAX_RESTART_ATTEMPTS = 10;
 
+	// Number of times generating a chunk's terrain is tried (with different random numbers) before giving up
+	// Chunk attempts never restart the solver: a new attempt does the same job, with its own random stream
+	// Gives the same number of solves as two attempts with MAX_RESTART_ATTEMPTS restarts each
+	constexpr uint32_t MAX_CHUNK_ATTEMPTS = 2 * (MAX_RESTART_ATTEMPTS + 1);
+
+	// Upper bound on the number of distinct tiles in the terrain generation rules
+	// One per sprite in the main spritesheet
+	constexpr uint32_t MAX_TERRAIN_OPTIONS = 256;
+
+	// Maximum random amount added to a cell's entropy, used to break ties between cells
+	constexpr float ENTROPY_NOISE = 0.001f;
+
+	// The entropy queue is rebuilt once it holds this many entries per cell, since most will be out of date
+	constexpr uint32_t MAX_ENTROPY_QUEUE_FACTOR = 8;
+
+	// Number of samples from every option's weights before an option is picked by walking through the cell's options instead
+	// Samples which aren't one of the cell's options are rejected, so this only matters for cells with a small share of the total weight
+	constexpr uint32_t MAX_OPTION_SAMPLE_ATTEMPTS = 4;
+
 	namespace PLAYER {
 		constexpr Framework::vec2 STARTING_POSITION = cmul(Framework::vec2{ 0.33f, 0.48f }, WINDOW::SIZE) / SPRITES::SCALE;
 
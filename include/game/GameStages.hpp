@@ -1,5 +1,8 @@
 #pragma once
 
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <optional>
 
 #include "Constants.hpp"
@@ -14,10 +17,13 @@
 
 class GameStage : public Framework::BaseStage {
 public:
+	// If deterministic, the level waits for chunks to be generated when they're late (see Level), so that the same input always gives the same ride
+	GameStage(uint32_t seed = 0, bool deterministic = false);
+
 	void start();
 
 	bool update(float dt);
-	void render();
+	void render(float alpha);
 
 private:
 	// Use std::unique_ptr so that we can delay construction without needing default ctors
@@ -25,6 +31,9 @@ private:
 	std::optional<Level> level;
 	std::optional<Hud> hud;
 
+	uint32_t _seed;
+	bool _deterministic;
+
 	bool _first_time = true;
 };
 
@@ -35,8 +44,49 @@ public:
 	void start();
 
 	bool update(float dt);
-	void render();
+	void render(float alpha);
 
 private:
 	BaseStage* _background_stage;
 };
+
+
+// Used in headless mode instead of the menus: runs rides one after another with scripted input, as fast as possible, and prints how they went
+// Each ride uses the next seed, and the results only depend on the seeds, so runs can be compared with each other
+class SimulationStage : public Framework::BaseStage {
+public:
+	SimulationStage(uint32_t ride_count, uint32_t first_seed);
+
+	void start();
+
+	bool update(float dt);
+	void render(float alpha);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	void start_ride();
+	void finish_ride(bool crashed);
+	void print_results();
+
+	std::optional<Player> player;
+	std::optional<Level> level;
+
+	uint32_t _ride_count;
+	uint32_t _first_seed;
+
+	uint32_t ride_index = 0;
+	uint32_t ride_ticks = 0;
+
+	// Totals over every ride
+	uint64_t total_ticks = 0;
+	uint32_t crashes = 0;
+	double total_distance = 0.0;
+	double level_update_seconds = 0.0;
+	double player_update_seconds = 0.0;
+
+	// Hash of where every ride ended, which only matches between runs if the simulation is deterministic
+	uint64_t checksum = 14695981039346656037ull;
+
+	Clock::time_point start_time;
+};
\ No newline at end of file
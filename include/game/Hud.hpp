@@ -1,10 +1,13 @@
 #pragma once
 
+#include <array>
+#include <cstdio>
 #include <memory>
 
 #include "Animation.hpp"
 #include "Font.hpp"
 #include "GraphicsObjects.hpp"
+#include "Profiler.hpp"
 
 #include "Constants.hpp"
 #include "Player.hpp"
@@ -14,11 +17,26 @@ public:
 	Hud(Framework::GraphicsObjects* _graphics_objects);
 
 	void update(float dt);
-	void render(const Player& player);
+	void render(const Player& player, const Level& level);
+
+	void toggle_overlay();
 
 private:
+	// Frame times, profiler zones, render statistics and chunk generation statistics
+	void render_overlay(const Level& level);
+
+	// Formats the line into line_buffer rather than a new string, so that the overlay doesn't allocate every frame
+	template <typename... Args>
+	void render_overlay_line(Framework::vec2& position, const char* format, Args... args) {
+		std::snprintf(line_buffer.data(), line_buffer.size(), format, args...);
+		graphics_objects->fonts[GRAPHICS_OBJECTS::FONTS::MAIN_FONT].render_text(line_buffer.data(), position, COLOURS::WHITE, OVERLAY::TEXT_SCALE, Framework::Font::AnchorPosition::TOP_LEFT);
+		position.y += OVERLAY::LINE_HEIGHT;
+	}
+
 	Framework::GraphicsObjects* graphics_objects;
 
 	std::unique_ptr<Framework::AnimationInterface> heart;
-	Framework::Text fps_text;
+
+	bool show_overlay = false;
+	std::array<char, OVERLAY::MAX_LINE_LENGTH> line_buffer{};
 };
@@ -1,29 +1,34 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
-#include <future>
 #include <map>
+#include <memory>
+#include <optional>
 
 #include "GraphicsObjects.hpp"
 #include "Maths.hpp"
+#include "Profiler.hpp"
+#include "SPSCQueue.hpp"
+#include "ThreadPool.hpp"
 
+#include "ChunkGenerator.hpp"
+#include "ChunkStore.hpp"
 #include "Constants.hpp"
-#include "Random.hpp"
 
 class Level {
 public:
-	enum class RailDirection {
-		NONE,
-		UP,
-		DOWN
-	};
+	typedef ChunkGenerator::RailDirection RailDirection;
 
-	Level(Framework::GraphicsObjects* _graphics_objects, uint32_t _seed);
+	// If wait_for_generation is true, update waits for chunks to be generated rather than letting the player get ahead of them
+	// Slower, but the level is then the same however fast it's updated (e.g. in a headless simulation)
+	// If headless is true, the level is never rendered, so no images are created or baked for the chunks
+	Level(Framework::GraphicsObjects* _graphics_objects, uint32_t _seed, bool _wait_for_generation = false, bool _headless = false);
 
-	void update(float dt, const Framework::vec2& player_pos, Framework::InputHandler* input);
-	void render();
+	void update(float dt, const Framework::vec2& player_position, const Framework::vec2& player_velocity, Framework::InputHandler* input);
+	void render(float alpha);
 
 	uint32_t get_seed();
 
@@ -31,30 +36,82 @@ public:
 	float rail_height_at(float x);
 	std::vector<std::pair<uint8_t, RailDirection>> get_rail_heights(uint32_t chunk_id);
 
+	// Shown by the performance overlay
+	uint32_t get_loaded_chunk_count() const;
+	uint32_t get_planned_chunk_count() const;
+
+	// Id and statistics of the chunk which was collected most recently
+	uint32_t get_last_chunk_id() const;
+	const ChunkGenerator::ChunkStatistics& get_last_chunk_statistics() const;
+
 private:
-	void generate_next_chunk();
+	typedef ChunkGenerator::Chunk Chunk;
+	typedef ChunkGenerator::ChunkColumn ChunkColumn;
+	typedef ChunkGenerator::ChunkPlan ChunkPlan;
+	typedef ChunkGenerator::RailHeights RailHeights;
+	typedef ChunkGenerator::TerrainSolver TerrainSolver;
+
+	typedef Framework::SPSCQueue<Chunk, GAME::MAX_LOADED_CHUNKS> ChunkQueue;
+
+	// Number of chunks to generate ahead of the right edge of the screen
+	uint32_t get_lookahead_chunks(const Framework::vec2& player_velocity);
+
+	// Plans the next chunk and queues it to be generated by the workers
+	void queue_next_chunk();
+
+	// Called by the workers: hands the finished chunk over to the main thread
+	void publish_chunk(Chunk&& chunk, uint32_t thread_index);
+
+	// Renders the chunk's tiles into its image, so that it can be drawn in one go
+	void bake_chunk(const Chunk& chunk);
+
+	// Moves any chunks which have finished generating into chunks, discarding any which are left of leftmost_chunk_id
+	// Called once per frame on the main thread, so chunks never change while the frame is being updated or rendered
+	void collect_generated_chunks(uint32_t leftmost_chunk_id);
+
+	// Only used when waiting for generation: sleeps until a worker publishes a chunk which hasn't been collected yet
+	void wait_for_published_chunk();
 
 	std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> get_overlapping_tile_coords(Framework::Rect rect);
 
 	Framework::GraphicsObjects* graphics_objects;
 
-	typedef std::array<uint32_t, GAME::CHUNK_TILE_HEIGHT> ChunkColumn;
-	typedef std::array<ChunkColumn, GAME::CHUNK_TILE_WIDTH> ChunkGrid;
+	ChunkStore<Chunk, GAME::MAX_LOADED_CHUNKS> chunks;
 
-	struct Chunk {
-		ChunkGrid chunk_grid;
-		std::vector<std::pair<uint8_t, RailDirection>> rail_heights;
-	};
-
-	std::map<uint32_t, Chunk> chunks; // Key of map determines chunk ID
+	// Tiles of each chunk, baked once when the chunk is loaded since chunks never change
+	// Uses the same slots as chunks, so the images are reused rather than created for each chunk
+	std::array<std::unique_ptr<Framework::Image>, GAME::MAX_LOADED_CHUNKS> chunk_images;
 	uint32_t next_chunk_id;
-	
+
+	// Plans for chunks which are still being generated
+	// The rail path is already known, so the player can keep moving even if the chunk isn't ready yet
+	std::map<uint32_t, ChunkPlan> planned_chunks;
+
+	// Chunks which have been generated but not yet collected, with one queue per worker so that each queue only has one producer
+	// Never fills up, since no more than MAX_LOADED_CHUNKS chunks are planned at once
+	std::vector<std::unique_ptr<ChunkQueue>> generated_chunks;
+
+	// Number of chunks pushed to and popped from generated_chunks, so that the main thread can wait for the workers without polling
+	std::atomic<uint32_t> published_chunk_count = 0;
+	uint32_t collected_chunk_count = 0;
+
+	uint32_t last_chunk_id = 0;
+	ChunkGenerator::ChunkStatistics last_chunk_statistics;
+
 	uint32_t seed;
-	XorShift random;
-	WaveFunctionCollapse wfc;
 
+	bool wait_for_generation;
+	bool headless;
+
+	ChunkGenerator chunk_generator;
+
+	// One solver per worker thread
+	std::vector<std::unique_ptr<TerrainSolver>> terrain_solvers;
+
+	// Scroll position at the last two updates, which rendering interpolates between
+	float previous_scroll = 0.0f;
 	float scroll = 0.0f;
 
-	std::future_status chunk_loader_status = std::future_status::ready;
-	std::future<void> chunk_loader_thread;
+	// Must be destroyed first, since the workers use the solvers
+	Framework::ThreadPool chunk_workers;
 };
\ No newline at end of file
@@ -13,7 +13,7 @@ public:
 	void start();
 
 	bool update(float dt);
-	void render();
+	void render(float alpha);
 
 private:
 	Framework::Timer intro_timer;
@@ -24,7 +24,7 @@ public:
 	void start();
 
 	bool update(float dt);
-	void render();
+	void render(float alpha);
 
 private:
 	Framework::Text title_text;
@@ -4,6 +4,7 @@
 #include <numbers>
 
 #include "GraphicsObjects.hpp"
+#include "Profiler.hpp"
 #include "Timer.hpp"
 
 #include "Constants.hpp"
@@ -12,13 +13,27 @@
 
 class Player {
 public:
+	// Everything needed to draw the player, so that rendering can interpolate between updates
+	struct State {
+		Framework::vec2 position;
+		float angle = 0.0f;
+	};
+
 	Player(Framework::GraphicsObjects* _graphics_objects);
 
 	void update(float dt, Framework::InputHandler* input, Level& level);
-	void render();
+	void render(float alpha);
 
 	uint8_t get_health() const;
 	Framework::vec2 get_position() const;
+	Framework::vec2 get_velocity() const;
+
+	// State before and after the last update
+	State get_previous_state() const;
+	State get_current_state() const;
+
+	// State between the last two updates, where alpha is from 0 (previous) to 1 (current)
+	State get_interpolated_state(float alpha) const;
 
 private:
 	Framework::vec2 position, velocity;
@@ -30,6 +45,8 @@ private:
 		float left_y, right_y;
 	} wheels;
 
+	State previous_state;
+
 	Framework::Timer start_delay;
 
 	Framework::GraphicsObjects* graphics_objects;
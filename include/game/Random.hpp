@@ -1,18 +1,29 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
-#include <map>
-#include <memory>
-#include <optional>
-#include <stack>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
-#include "File.hpp"
+// Walker's alias method: building the table is O(n), but then each weighted sample is O(1)
+class AliasTable {
+public:
+	AliasTable() = default;
+	AliasTable(std::span<const uint32_t> weights);
+
+	// Number of items, or 0 if none of the items have any weight
+	uint32_t size() const;
 
-#include "Constants.hpp"
+private:
+	friend class RandomGenerator;
+
+	// Each column has the probability of picking the column's own item, otherwise its alias is picked
+	std::vector<float> probabilities;
+	std::vector<uint32_t> aliases;
+};
 
 class RandomGenerator {
 public:
@@ -27,7 +38,8 @@ public:
 		if (v.size() == 0) {
 			throw std::runtime_error("Cannot randomly select item from empty list!");
 		}
-		uint32_t index = static_cast<uint32_t>(random() * v.size());
+		// random() can return exactly 1.0, so clamp to the last item
+		uint32_t index = std::min(static_cast<uint32_t>(random() * v.size()), static_cast<uint32_t>(v.size() - 1));
 		return v.at(index);
 	}
 
@@ -35,7 +47,11 @@ public:
 	T choice(const std::vector<T>& v, const std::vector<uint32_t>& w) {
 		uint32_t sum = 0;
 		for (uint32_t a : w) sum += a;
-		uint32_t index = static_cast<uint32_t>(random() * sum);
+
+		// Nothing has any weight, so treat every item equally
+		if (sum == 0) return choice(v);
+
+		uint32_t index = std::min(static_cast<uint32_t>(random() * sum), sum - 1);
 		uint32_t i = 0;
 		//std::cout << "sum: " << sum << ", index: " << index;
 		//std::cout << "i: " << i << ", w: " << w.at(i) << ", index: " << index << std::endl;
@@ -50,6 +66,17 @@ public:
 		return v.at(i);
 	}
 
+	// Returns the index of an item chosen with the weights the table was built from
+	uint32_t sample(const AliasTable& table);
+
+	template <typename T>
+	T choice(const std::vector<T>& v, const AliasTable& table) {
+		if (table.size() != v.size()) {
+			throw std::runtime_error("Alias table doesn't match the list of items!");
+		}
+		return v.at(sample(table));
+	}
+
 protected:
 	uint32_t seed;
 };
@@ -77,68 +104,26 @@ private:
 	uint32_t state;
 };
 
-class WaveFunctionCollapse {
+// Counter-based generator: each number only depends on the key and how many numbers came before it
+// The key is derived from the seed, stream and attempt, so independent streams can be created for any combination of them
+// (e.g. one per chunk) without having to generate anything else first
+class SplitMix : public RandomGenerator {
 public:
-	struct ValidOptions {
-		std::vector<uint32_t> up, down, left, right;
-	};
-
-	struct OptionCollections {
-		std::vector<uint32_t> all, terrain, rail;
-	};
+	SplitMix(uint32_t _seed, uint32_t _stream = 0, uint32_t _attempt = 0);
 
-	WaveFunctionCollapse(uint8_t _width, uint8_t _height, OptionCollections _options, std::map<uint32_t, uint32_t> _relative_frequencies, std::map<uint32_t, ValidOptions> _valid_options_lookup);
-
-	static WaveFunctionCollapse create_from_file(uint8_t _width, uint8_t _height, std::string filepath);
-
-	void reset();
-
-	void set_cell(uint8_t x, uint8_t y, uint32_t value);
-	void set_cell(uint8_t x, uint8_t y, std::vector<uint32_t> values);
-	std::optional<uint32_t> get_cell(uint8_t x, uint8_t y);
-	std::vector<uint32_t> get_cell_options(uint8_t x, uint8_t y);
-	bool is_cell_collapsed(uint8_t x, uint8_t y);
-
-	bool collapse_single_cell(RandomGenerator& random);
-	bool collapse(RandomGenerator& random);
+	uint32_t get_next();
 
-	OptionCollections get_option_collections();
+	// Returns the number which get_next() gives after counter numbers have been generated, without changing the state
+	uint32_t at(uint64_t counter) const;
+	uint64_t get_counter() { return counter; }
 
 private:
-	void update_options();
-	void update_surrounding_options(uint8_t x, uint8_t y);
-
-	void reduce_options(uint8_t x, uint8_t y, std::vector<uint32_t> valid_options);
-
-	void backtrack();
-	void restart();
+	static uint64_t mix(uint64_t value);
 
-	const std::vector<std::pair<int, int>> directions = {
-		{  0, -1 }, // up
-		{  0,  1 }, // down
-		{ -1,  0 }, // left
-		{  1,  0 }, // right
-	};
+	// Added to the state between each number
+	static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
 
-	struct Cell {
-		bool collapsed;
-		std::vector<uint32_t> options;
-	};
-
-	struct Decision {
-		std::vector<Cell> previous_state;
-		uint8_t x, y;
-		uint32_t chosen_value;
-	};
-
-	const OptionCollections options;
-
-	const std::map<uint32_t, uint32_t> relative_frequencies;
-	const std::map<uint32_t, ValidOptions> valid_options_lookup;
-
-	uint8_t width, height;
-	std::vector<Cell> cells;
-
-	//std::vector<Cell> initial_state;
-	std::stack<Decision> history;
+	uint64_t key;
+	uint64_t counter = 0;
 };
+
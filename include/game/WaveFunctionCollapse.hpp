@@ -0,0 +1,356 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "File.hpp"
+
+#include "Constants.hpp"
+#include "Random.hpp"
+
+// Types shared by every variant of the solver
+namespace WFC {
+	struct ValidOptions {
+		std::vector<uint32_t> up, down, left, right;
+	};
+
+	struct OptionCollections {
+		std::vector<uint32_t> all, terrain, rail;
+	};
+
+	// Set of options for a cell, stored as one bit per dense option index.
+	// Intersecting two sets is then just a word-wise AND.
+	// MaxOptions fixes the number of words, so rule tables with fewer options give smaller sets.
+	template <uint32_t MaxOptions>
+	class OptionBitset {
+	public:
+		static constexpr uint32_t WORD_SIZE = 64;
+		static constexpr uint32_t WORD_COUNT = (MaxOptions + WORD_SIZE - 1) / WORD_SIZE;
+
+		// Returned by first() and next() when there are no more set bits
+		static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+		constexpr OptionBitset() = default;
+		constexpr explicit OptionBitset(const std::array<uint64_t, WORD_COUNT>& _words) : words(_words) {}
+
+		constexpr void set(uint32_t index) { words[index / WORD_SIZE] |= 1ULL << (index % WORD_SIZE); }
+		constexpr void reset(uint32_t index) { words[index / WORD_SIZE] &= ~(1ULL << (index % WORD_SIZE)); }
+		constexpr bool test(uint32_t index) const { return (words[index / WORD_SIZE] >> (index % WORD_SIZE)) & 1ULL; }
+
+		constexpr uint32_t count() const {
+			uint32_t total = 0;
+			for (uint64_t word : words) total += std::popcount(word);
+			return total;
+		}
+
+		constexpr bool empty() const {
+			for (uint64_t word : words) {
+				if (word) return false;
+			}
+			return true;
+		}
+
+		// Lowest set index, or NONE if the set is empty
+		constexpr uint32_t first() const {
+			for (uint32_t i = 0; i < WORD_COUNT; i++) {
+				if (words[i]) return i * WORD_SIZE + std::countr_zero(words[i]);
+			}
+			return NONE;
+		}
+
+		// Lowest set index greater than index, or NONE if there isn't one
+		constexpr uint32_t next(uint32_t index) const {
+			index++;
+			uint32_t i = index / WORD_SIZE;
+			if (i >= WORD_COUNT) return NONE;
+
+			// Mask off the bits we've already visited in the current word
+			uint64_t word = words[i] & (~0ULL << (index % WORD_SIZE));
+			while (!word) {
+				if (++i >= WORD_COUNT) return NONE;
+				word = words[i];
+			}
+			return i * WORD_SIZE + std::countr_zero(word);
+		}
+
+		constexpr OptionBitset& operator&=(const OptionBitset& other) {
+			for (uint32_t i = 0; i < WORD_COUNT; i++) words[i] &= other.words[i];
+			return *this;
+		}
+
+		constexpr OptionBitset& operator|=(const OptionBitset& other) {
+			for (uint32_t i = 0; i < WORD_COUNT; i++) words[i] |= other.words[i];
+			return *this;
+		}
+
+		constexpr bool operator==(const OptionBitset& other) const = default;
+
+	private:
+		std::array<uint64_t, WORD_COUNT> words{};
+	};
+
+	// Order must match ValidOptions: up, down, left, right
+	constexpr uint8_t DIRECTION_COUNT = 4;
+
+	// Used in RuleSet::option_indices for values which aren't options
+	constexpr uint32_t NO_OPTION = std::numeric_limits<uint32_t>::max();
+
+	// Rule tables loaded at runtime, so that the rules can be changed without recompiling (e.g. for modding)
+	// The tables are views into storage which is either built from the JSON rules, or is a memory-mapped rule pack
+	// Rule tables generated at compile time (see CompiledTerrainRules) provide the same members as fixed-size constexpr arrays
+	struct RuleSet {
+		typedef OptionBitset<GAME::MAX_TERRAIN_OPTIONS> OptionSet;
+
+		OptionCollections options;
+
+		// Options are stored as dense indices into these tables, rather than their original values
+		std::span<const uint32_t> option_values;
+		std::span<const uint32_t> relative_frequencies;
+
+		// Cached w * log(w) for each option's relative frequency w, used when calculating entropy
+		std::span<const float> weight_log_weights;
+
+		// For each option, the options allowed in the adjacent cell in each direction
+		// The support for a cell in a direction is the union of these over all of the cell's options
+		std::span<const std::array<OptionSet, DIRECTION_COUNT>> valid_options_lookup;
+
+		// Dense index of each value, or NO_OPTION if the value isn't an option
+		std::span<const uint32_t> option_indices;
+
+		// Keeps whatever the tables point into alive
+		std::shared_ptr<const void> storage;
+	};
+}
+
+// Rules is either WFC::RuleSet, or a type with the same members generated from the rules at compile time
+template <typename Rules>
+class BasicWaveFunctionCollapse {
+public:
+	typedef WFC::ValidOptions ValidOptions;
+	typedef WFC::OptionCollections OptionCollections;
+	typedef typename Rules::OptionSet OptionSet;
+
+	static constexpr uint8_t DIRECTION_COUNT = WFC::DIRECTION_COUNT;
+	static constexpr uint32_t NO_OPTION = WFC::NO_OPTION;
+
+	// Counts of the work done since the last reset
+	struct Statistics {
+		uint32_t decisions = 0;
+		uint32_t backtracks = 0;
+		uint32_t restarts = 0;
+
+		Statistics& operator+=(const Statistics& other);
+	};
+
+	BasicWaveFunctionCollapse(uint8_t _width, uint8_t _height, Rules _rules = Rules());
+
+	void reset();
+
+	void set_cell(uint8_t x, uint8_t y, uint32_t value);
+	void set_cell(uint8_t x, uint8_t y, std::vector<uint32_t> values);
+	std::optional<uint32_t> get_cell(uint8_t x, uint8_t y);
+	std::vector<uint32_t> get_cell_options(uint8_t x, uint8_t y);
+	bool is_cell_collapsed(uint8_t x, uint8_t y);
+
+	// Returns true if value is one of the options in the rule set
+	bool is_option(uint32_t value);
+
+	bool collapse_single_cell(RandomGenerator& random);
+	// Starts again from the beginning after MAX_COLLAPSE_ATTEMPTS steps, up to max_restarts times
+	// Gives up (returning false) when it would need another restart
+	bool collapse(RandomGenerator& random, uint32_t max_restarts = GAME::MAX_RESTART_ATTEMPTS);
+
+	OptionCollections get_option_collections();
+
+	Statistics get_statistics();
+
+protected:
+	// Converts a list of options into the equivalent set of dense indices, ignoring any unknown options
+	static OptionSet to_option_set(std::span<const uint32_t> option_indices, const std::vector<uint32_t>& values);
+
+private:
+	void update_options();
+
+	// Removes options from the neighbours of every queued cell which none of the queued cell's options allow
+	// Any neighbour which loses options is queued in turn, until nothing changes or a cell runs out of options
+	void propagate();
+	void queue_propagation(uint32_t index);
+
+	// Removes any options not in valid_options from the cell, and queues it for propagation if that changed anything
+	void reduce_options(uint8_t x, uint8_t y, const OptionSet& valid_options);
+
+	void backtrack();
+	void restart();
+
+	// Saves the cell's current state to the trail (if needed) so that it can be restored by backtrack() or restart()
+	// Must be called before any change to a cell
+	void record_cell(uint32_t index);
+
+	// Restores cells from the trail until it is trail_size long
+	void undo_trail(size_t trail_size);
+
+	// Changes a cell's state, keeping the trail, entropy queue and contradiction count up to date
+	void update_cell(uint32_t index, bool collapsed, const OptionSet& cell_options);
+
+	// Shannon entropy of the relative frequencies of the options
+	float calculate_entropy(const OptionSet& cell_options);
+
+	// Randomly picks one of the options, weighted by relative frequency
+	uint32_t choose_option(const OptionSet& cell_options, RandomGenerator& random);
+
+	// Adds the cell's current entropy to the queue, invalidating any older entries for that cell
+	void queue_cell(uint32_t index);
+	void build_entropy_queue();
+
+	OptionSet to_option_set(const std::vector<uint32_t>& values);
+
+	// Each direction's opposite is found by flipping the lowest bit of its index
+	static constexpr std::array<std::pair<int, int>, DIRECTION_COUNT> directions = { {
+		{  0, -1 }, // up
+		{  0,  1 }, // down
+		{ -1,  0 }, // left
+		{  1,  0 }, // right
+	} };
+
+	struct Cell {
+		bool collapsed;
+		OptionSet options;
+	};
+
+	// Previous state of a cell which was changed after a decision was made
+	struct TrailEntry {
+		uint32_t index;
+		Cell previous;
+	};
+
+	struct EntropyEntry {
+		float entropy;
+		uint32_t index;
+
+		// Entry is out of date if this doesn't match the cell's version
+		uint32_t version;
+
+		// Reversed, so that std::priority_queue gives the lowest entropy first
+		bool operator<(const EntropyEntry& other) const { return entropy > other.entropy; }
+	};
+
+	struct Decision {
+		// Length of the trail when the decision was made: everything after this was caused by the decision
+		size_t trail_size;
+		uint8_t x, y;
+		uint32_t chosen_index;
+	};
+
+	const Rules rules;
+
+	OptionSet all_options;
+
+	// Support of a cell which still has every option, since most cells are like this for most of the solve
+	std::array<OptionSet, DIRECTION_COUNT> all_options_supported{};
+
+	// Samples from every option's relative frequency
+	AliasTable option_sampler;
+
+	uint8_t width, height;
+	std::vector<Cell> cells;
+
+	std::stack<Decision> history;
+	std::vector<TrailEntry> trail;
+
+	// A cell only needs saving to the trail once per decision, so cells are marked with the stamp of the last decision they were saved for
+	std::vector<uint32_t> cell_stamps;
+	uint32_t current_stamp = 0;
+
+	// Cells which have been changed are pushed again rather than updated, so old entries are skipped when popped
+	std::priority_queue<EntropyEntry> entropy_queue;
+	std::vector<uint32_t> cell_versions;
+	bool entropy_queue_built = false;
+
+	// Small random offset added to each cell's entropy, so that ties are broken randomly
+	std::vector<float> cell_noise;
+
+	// Number of cells with no options left: if this isn't zero, the grid needs backtracking
+	uint32_t empty_cells = 0;
+
+	// Cells whose options have changed, but whose neighbours haven't been updated yet
+	std::vector<uint32_t> propagation_queue;
+	std::vector<bool> propagation_queued;
+
+	Statistics statistics;
+};
+
+// Solver using rules loaded at runtime
+class WaveFunctionCollapse : public BasicWaveFunctionCollapse<WFC::RuleSet> {
+public:
+	typedef WFC::RuleSet RuleSet;
+
+	using BasicWaveFunctionCollapse::BasicWaveFunctionCollapse;
+	WaveFunctionCollapse(uint8_t _width, uint8_t _height, OptionCollections _options, std::map<uint32_t, uint32_t> _relative_frequencies, std::map<uint32_t, ValidOptions> _valid_options_lookup);
+
+	// Accepts either a JSON rule file or a rule pack (see load_rules)
+	static WaveFunctionCollapse create_from_file(uint8_t _width, uint8_t _height, std::string filepath);
+
+	// Compiles the rules into dense tables
+	static RuleSet create_rules(OptionCollections _options, std::map<uint32_t, uint32_t> _relative_frequencies, std::map<uint32_t, ValidOptions> _valid_options_lookup);
+
+	// Loads a rule pack if the file has the rule pack extension, otherwise parses it as a JSON rule file
+	static RuleSet load_rules(std::string filepath);
+
+	// Rule packs are created from the JSON rules at build time by the rule compiler, and can be used without any parsing
+	static RuleSet load_rule_pack(std::string filepath);
+	static bool write_rule_pack(const RuleSet& rules, std::string filepath);
+
+private:
+	// Storage for rules created by create_rules
+	struct RuleStorage {
+		std::vector<uint32_t> option_values;
+		std::vector<uint32_t> relative_frequencies;
+		std::vector<float> weight_log_weights;
+		std::vector<std::array<OptionSet, DIRECTION_COUNT>> valid_options_lookup;
+		std::vector<uint32_t> option_indices;
+	};
+
+	// Rule packs are the header, followed by valid_options_lookup (first so that its words stay aligned), option_values, relative_frequencies,
+	// weight_log_weights and option_indices, then the terrain and rail collections
+	// The tables are mapped as they are, so a pack can only be used on a machine with the same byte order as the one which wrote it
+	struct RulePackHeader {
+		uint32_t magic;
+		uint32_t version;
+
+		// Must match OptionSet::WORD_COUNT
+		uint32_t word_count;
+
+		uint32_t option_count;
+		uint32_t option_indices_size;
+		uint32_t terrain_count;
+		uint32_t rail_count;
+
+		// RULE_PACK_BYTE_ORDER, as written by the machine which compiled the pack
+		uint32_t byte_order;
+	};
+
+	static constexpr uint32_t RULE_PACK_MAGIC = 0x52434657; // "WFCR"
+	static constexpr uint32_t RULE_PACK_VERSION = 2;
+
+	// Reads back differently on a machine with the other byte order
+	static constexpr uint32_t RULE_PACK_BYTE_ORDER = 0x01020304;
+
+	// Largest option value allowed, so that option_indices can be a lookup table
+	static constexpr uint32_t MAX_OPTION_VALUE = 0xFFFF;
+};
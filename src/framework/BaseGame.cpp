@@ -1,11 +1,68 @@
 #include "BaseGame.hpp"
 
 namespace Framework {
+	LaunchOptions LaunchOptions::parse(int argc, char* argv[]) {
+		LaunchOptions options;
+
+		// First argument is the program
+		for (int i = 1; i < argc; i++) {
+			std::string argument = argv[i];
+
+			if (argument == "--render-thread") {
+				options.render_thread = true;
+			}
+			else if (argument == "--single-thread") {
+				options.render_thread = false;
+			}
+			else if (argument == "--headless") {
+				options.headless = true;
+			}
+			else if (argument == "--record" && i + 1 < argc) {
+				options.record_path = argv[++i];
+			}
+			else if (argument == "--replay" && i + 1 < argc) {
+				options.replay_path = argv[++i];
+			}
+			else if ((argument == "--rides" || argument == "--seed") && i + 1 < argc) {
+				uint32_t& value = argument == "--rides" ? options.rides : options.seed;
+
+				try {
+					value = std::stoul(argv[++i]);
+				}
+				catch (const std::exception&) {
+					printf("Ignoring invalid value %s for %s\n", argv[i], argument.c_str());
+				}
+			}
+			else {
+				printf("Ignoring unknown option %s\n", argument.c_str());
+			}
+		}
+
+		return options;
+	}
+
 	BaseGame::BaseGame() {
 
 	}
 
-	bool BaseGame::run() {
+	bool BaseGame::run(const LaunchOptions& options) {
+		launch_options = options;
+
+		if (!launch_options.replay_path.empty()) {
+			if (!input_recording.load(launch_options.replay_path)) {
+				return false;
+			}
+
+			// Replays have to use the same level as when they were recorded
+			launch_options.seed = input_recording.get_seed();
+			launch_options.record_path.clear();
+
+			printf("Replaying %u updates from %s\n", input_recording.get_update_count(), launch_options.replay_path.c_str());
+		}
+		else if (!launch_options.record_path.empty()) {
+			input_recording = InputRecording(launch_options.seed);
+		}
+
 		// Initialise SDL and globals - if it fails, don't run program
 		if (!init()) {
 			return false;
@@ -16,11 +73,45 @@ namespace Framework {
 		start();
 		stage->init(&graphics_objects, &input);
 
+		// Nothing is presented in headless mode, so there's nothing for a render thread to do
+		if (options.render_thread && !options.headless) {
+			render_thread = std::make_unique<RenderThread>(&graphics_objects.graphics, window, &graphics_objects.back_render_queue);
+			graphics_objects.graphics.set_render_thread(render_thread.get());
+		}
+
+		// Time frames from now, rather than from when the program started
+		last_time = FrameLimiter::Clock::now();
+		frame_limiter = FrameLimiter(WINDOW::TARGET_DT);
+		accumulator = 0.0f;
+
 		// Main game loop
+		FrameLimiter::Clock::time_point loop_start = FrameLimiter::Clock::now();
+		uint32_t frames = 0;
+
 		bool running = true;
 		while (running) {
-			running = main_loop();
+			running = options.headless ? headless_loop() : main_loop();
+			frames++;
+		}
+
+		if (!launch_options.replay_path.empty()) {
+			// Replays always run the same updates, so this can be compared between builds
+			float seconds = std::chrono::duration<float>(FrameLimiter::Clock::now() - loop_start).count();
+			printf("Replay took %.2fs over %u frames (%.3fms per frame)\n", seconds, frames, seconds * 1000.0f / frames);
+		}
+		else if (!launch_options.record_path.empty()) {
+			if (input_recording.save(launch_options.record_path)) {
+				printf("Recorded %u updates to %s\n", input_recording.get_update_count(), launch_options.record_path.c_str());
+			}
 		}
+
+#ifdef PROFILER_ENABLED
+		Profiler::get().print_report();
+#endif
+
+		// Wait for the last frame to be presented, so that the renderer can be used directly again
+		graphics_objects.graphics.set_render_thread(nullptr);
+		render_thread.reset();
 		
 		// Allow game to clean up
 		end();
@@ -31,18 +122,17 @@ namespace Framework {
 		return true;
 	}
 
-	// Limit framerate and get approximate dt
-	// Limiting is inaccurate: alright for 60fps (+/- ~2fps), 120fps gets inaccurate (+/- ~10fps) and higher framerates are worse.
-	// This is due to SDL working in milliseconds, so we can't do any better than 1000/17 = 111 fps or 1000/8 = 125 fps
+	// Limit framerate and get dt
+	// Both use the steady clock rather than SDL_GetTicks, which only works in milliseconds (so 120fps would be anywhere between 111fps and 125fps)
 	bool BaseGame::main_loop() {
 		// Get start time
-		uint32_t start_time = SDL_GetTicks();
+		FrameLimiter::Clock::time_point start_time = FrameLimiter::Clock::now();
 
 		// 'Calculate' dt
 		//float dt = WINDOW::TARGET_DT;
 
 		// Or we could get last frame's dt - this is better
-		float dt = (start_time - last_time) / 1000.0f;
+		float dt = std::chrono::duration<float>(start_time - last_time).count();
 		last_time = start_time;
 
 		// Cap dt - stops game skipping time when window is dragged (which caused objects to phase through other objects)
@@ -50,33 +140,28 @@ namespace Framework {
 		// While window is dragged, dt accumulates because main_loop isn't called, so dt because very large
 		dt = std::min(dt, WINDOW::MAX_DT);
 
-		// Update input handler (updates all key states etc)
-		input.update();
+		// Time which hasn't been simulated yet
+		accumulator += dt;
 
 		// Handle events
-		SDL_Event sdl_event;
-		while (SDL_PollEvent(&sdl_event) != 0) {
-			switch (sdl_event.type) {
-			case SDL_QUIT:
-				// X (close) is pressed
-				return false;
+		if (!handle_events()) {
+			return false;
+		}
 
-			case SDL_KEYDOWN:
-			case SDL_KEYUP:
-			case SDL_MOUSEMOTION:
-			case SDL_MOUSEBUTTONDOWN:
-			case SDL_MOUSEBUTTONUP:
-			case SDL_MOUSEWHEEL:
-				// Delegate to InputHandler
-				input.handle_sdl_event(sdl_event);
-				break;
+		// Run as many fixed updates as fit in the time since the last one
+		// There can be none if frames are drawn faster than UPDATE_RATE, or several if they're drawn slower
+		bool running = true;
+		while (running && accumulator >= WINDOW::UPDATE_DT) {
+			running = update(WINDOW::UPDATE_DT);
+			accumulator -= WINDOW::UPDATE_DT;
 
-			default:
-				break;
-			}
+			// Update input handler (updates all key states etc)
+			// Done after each update rather than each frame, so that keys pressed since the last update are seen by exactly one update
+			input.update();
 		}
 
-		bool running = update(dt);
+		// How far between the last update and the next one this frame is drawn
+		float alpha = accumulator / WINDOW::UPDATE_DT;
 
 		// Clear the screen
 		/*SDLUtils::SDL_SetRenderDrawColor(renderer, COLOURS::BLACK);
@@ -84,28 +169,82 @@ namespace Framework {
 		graphics_objects.graphics.fill(COLOURS::BLACK);
 
 		// Render game
-		render();
+		render(alpha);
 
-		// Update screen
-		SDL_RenderPresent(renderer);
+		// Draw everything recorded during the frame, and update screen
+		// With a render thread, this only waits for the previous frame, and the frame is drawn while the next one is updated
+		graphics_objects.graphics.present();
 
 		// If we were too quick, sleep!
 		if (WINDOW::LIMIT_FPS) {
-			uint32_t end_time = SDL_GetTicks();
-			uint32_t difference = end_time - start_time;
-			int ticks_to_sleep = static_cast<int>(WINDOW::TARGET_DT * 1000.0f) - difference;
-			if (ticks_to_sleep > 0) {
-				SDL_Delay(ticks_to_sleep);
-			}
+			frame_limiter.wait();
 		}
 
+		// Frame is timed from the end of the last one, so that the time includes everything (even the sleep)
+		PROFILE_END_FRAME();
+
 		//printf("Delta: %f\n", dt);
 		//printf("FPS: %f\n", 1.0f / dt);
 
 		return running;
 	}
 
+	bool BaseGame::headless_loop() {
+		// Still needed so that the program can be stopped (e.g. with Ctrl+C), although the dummy video driver never sends any input
+		if (!handle_events()) {
+			return false;
+		}
+
+		// Nothing is drawn at all, so the render queue is never flushed
+		bool running = update(WINDOW::UPDATE_DT);
+		input.update();
+
+		PROFILE_END_FRAME();
+
+		return running;
+	}
+
+	bool BaseGame::handle_events() {
+		PROFILE_ZONE("Event pumping");
+
+		SDL_Event sdl_event;
+		while (SDL_PollEvent(&sdl_event) != 0) {
+			switch (sdl_event.type) {
+			case SDL_QUIT:
+				// X (close) is pressed
+				return false;
+
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+			case SDL_MOUSEMOTION:
+			case SDL_MOUSEBUTTONDOWN:
+			case SDL_MOUSEBUTTONUP:
+			case SDL_MOUSEWHEEL:
+				// Delegate to InputHandler, unless the input is coming from a replay
+				if (launch_options.replay_path.empty()) {
+					input.handle_sdl_event(sdl_event);
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		return true;
+	}
+
 	bool BaseGame::update(float dt) {
+		// Input is recorded or played back per update rather than per frame, so that it lines up with the same updates whatever the frame rate
+		if (!launch_options.replay_path.empty()) {
+			if (!input_recording.replay(input)) {
+				return false;
+			}
+		}
+		else if (!launch_options.record_path.empty()) {
+			input_recording.record(input);
+		}
+
 		if (stage->finished()) {
 			// Allow user to clear up anything
 			stage->end();
@@ -127,13 +266,13 @@ namespace Framework {
 		return running;
 	}
 
-	void BaseGame::render() {
-		stage->render();
+	void BaseGame::render(float alpha) {
+		stage->render(alpha);
 	}
 
 	bool BaseGame::init() {
 		// Prep SDL, return false if it fails
-		if (!Framework::SDLUtils::init_sdl(window, renderer, WINDOW::TITLE, WINDOW::SIZE)) {
+		if (!Framework::SDLUtils::init_sdl(window, renderer, WINDOW::TITLE, WINDOW::SIZE, launch_options.headless)) {
 			return false;
 		}
 
@@ -141,6 +280,10 @@ namespace Framework {
 		graphics_objects.graphics = Graphics();
 		graphics_objects.graphics.set_renderer(renderer);
 
+		graphics_objects.render_queue = RenderQueue(&graphics_objects.graphics);
+		graphics_objects.back_render_queue = RenderQueue(&graphics_objects.graphics);
+		graphics_objects.graphics.set_render_queue(&graphics_objects.render_queue);
+
 		graphics_objects.window = Window();
 		graphics_objects.window.set_window(window);
 
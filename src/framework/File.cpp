@@ -1,10 +1,115 @@
 #include "File.hpp"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Framework {
 	std::string get_directory_path(std::string filepath) {
 		return filepath.substr(0, filepath.find_last_of("\\/"));
 	}
 
+	MappedFile::MappedFile() {
+
+	}
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+	bool MappedFile::open(std::string filepath) {
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			printf("Unable to open %s for mapping!\n", filepath.c_str());
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+			printf("Unable to map %s: file is empty!\n", filepath.c_str());
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		if (view == NULL) {
+			printf("Unable to map %s!\n", filepath.c_str());
+			if (mapping) CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		file_handle = file;
+		mapping_handle = mapping;
+		_data = static_cast<const uint8_t*>(view);
+		_size = static_cast<size_t>(file_size.QuadPart);
+#else
+		int file = ::open(filepath.c_str(), O_RDONLY);
+		if (file < 0) {
+			printf("Unable to open %s for mapping!\n", filepath.c_str());
+			return false;
+		}
+
+		struct stat file_stat;
+		if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+			printf("Unable to map %s: file is empty!\n", filepath.c_str());
+			::close(file);
+			return false;
+		}
+
+		void* view = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		// The mapping stays valid after the file descriptor is closed
+		::close(file);
+
+		if (view == MAP_FAILED) {
+			printf("Unable to map %s!\n", filepath.c_str());
+			return false;
+		}
+
+		_data = static_cast<const uint8_t*>(view);
+		_size = static_cast<size_t>(file_stat.st_size);
+#endif
+
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (_data == nullptr) return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(_data);
+		CloseHandle(mapping_handle);
+		CloseHandle(file_handle);
+		mapping_handle = nullptr;
+		file_handle = nullptr;
+#else
+		munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+		_data = nullptr;
+		_size = 0;
+	}
+
+	const uint8_t* MappedFile::data() const {
+		return _data;
+	}
+
+	size_t MappedFile::size() const {
+		return _size;
+	}
+
 	namespace JSONHandler {
 		// Uses https://github.com/nlohmann/json
 
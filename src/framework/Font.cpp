@@ -1,5 +1,7 @@
 #include "Font.hpp"
 
+#include "RenderQueue.hpp"
+
 namespace Framework {
 	const uint8_t FONT_SHEET_WIDTH = 32;
 	const uint8_t FONT_SHEET_HEIGHT = 3;
@@ -110,11 +112,11 @@ namespace Framework {
 		font_spritesheet_ptr->get_image()->refresh(Image::Flags::SDL_SURFACE);
 	}
 
-	void Font::render_text(std::string text, vec2 position, Colour colour, AnchorPosition anchor_position) {
+	void Font::render_text(std::string_view text, vec2 position, Colour colour, AnchorPosition anchor_position) {
 		render_text(text, position, colour, font_spritesheet_ptr->get_scale(), anchor_position);
 	}
 
-	void Font::render_text(std::string text, vec2 position, Colour colour, float scale, AnchorPosition anchor_position) {
+	void Font::render_text(std::string_view text, vec2 position, Colour colour, float scale, AnchorPosition anchor_position) {
 		set_colour(colour);
 
 		vec2 current_position = position / scale;
@@ -153,6 +155,11 @@ namespace Framework {
 			// Update current_position.x by getting character width
 			current_position.x += character_rect(c).size.x + _spacing;
 		}
+
+		// Colour is per sprite when queued, so anything else recorded afterwards shouldn't be coloured
+		if (RenderQueue* queue = font_spritesheet_ptr->get_image()->get_render_queue()) {
+			queue->set_colour(Colour(0xFF, 0xFF, 0xFF));
+		}
 	}
 
 	Rect Font::character_rect(uint8_t c) {
@@ -176,7 +183,14 @@ namespace Framework {
 	}
 
 	void Font::set_colour(Colour colour) {
-		SDLUtils::SDL_SetTextureColorMod(font_spritesheet_ptr->get_image()->get_texture(), colour);
+		// Colouring the texture would also colour any text from earlier which hasn't been drawn yet, so the colour is recorded with each character instead
+		// This also means that text in different colours can be drawn together
+		if (RenderQueue* queue = font_spritesheet_ptr->get_image()->get_render_queue()) {
+			queue->set_colour(colour);
+		}
+		else {
+			SDLUtils::SDL_SetTextureColorMod(font_spritesheet_ptr->get_image()->get_texture(), colour);
+		}
 	}
 
 	// Text
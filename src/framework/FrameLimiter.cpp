@@ -0,0 +1,48 @@
+#include "FrameLimiter.hpp"
+
+namespace Framework {
+	FrameLimiter::FrameLimiter() {
+
+	}
+
+	FrameLimiter::FrameLimiter(float frame_time) {
+		_frame_time = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(frame_time));
+		_frame_end = Clock::now();
+	}
+
+	void FrameLimiter::wait() {
+		_frame_end += _frame_time;
+
+		Clock::time_point now = Clock::now();
+		if (now >= _frame_end) {
+			// Too slow: start the next frame straight away
+			_frame_end = now;
+			return;
+		}
+
+		sleep_until(_frame_end);
+	}
+
+	void FrameLimiter::sleep_until(Clock::time_point time) {
+		while (std::chrono::duration<double>(time - Clock::now()).count() > _sleep_estimate) {
+			Clock::time_point sleep_start = Clock::now();
+			std::this_thread::sleep_for(SLEEP_STEP);
+			add_sleep_sample(std::chrono::duration<double>(Clock::now() - sleep_start).count());
+		}
+
+		// Spin for the rest, which is too short to sleep for without overshooting
+		while (Clock::now() < time) {
+			std::this_thread::yield();
+		}
+	}
+
+	void FrameLimiter::add_sleep_sample(double seconds) {
+		_sleep_count++;
+
+		double delta = seconds - _sleep_mean;
+		_sleep_mean += delta / _sleep_count;
+		_sleep_m2 += delta * (seconds - _sleep_mean);
+
+		_sleep_estimate = _sleep_mean + std::sqrt(_sleep_m2 / (_sleep_count - 1));
+	}
+}
\ No newline at end of file
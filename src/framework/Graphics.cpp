@@ -1,11 +1,19 @@
 #include "Graphics.hpp"
 
+#include "RenderQueue.hpp"
+#include "RenderThread.hpp"
+
 namespace Framework {
 	Graphics::Graphics() {
 
 	}
 
 	void Graphics::fill(const Colour& colour) {
+		if (render_queue) {
+			render_queue->fill(colour);
+			return;
+		}
+
 		set_colour(colour);
 
 		// NULL means draw rect over whole renderer
@@ -17,6 +25,11 @@ namespace Framework {
 	}
 
 	void Graphics::fill(const Rect& rect, const Colour& colour) {
+		if (render_queue) {
+			render_queue->fill(rect, colour);
+			return;
+		}
+
 		set_colour(colour);
 		SDLUtils::SDL_RenderFillRect(renderer, rect); // Maybe can use the overloaded version with a colour parameter?
 	}
@@ -26,6 +39,11 @@ namespace Framework {
 	}
 
 	void Graphics::render_line(const vec2& start, const vec2& end, const Colour& colour) {
+		if (render_queue) {
+			render_queue->line(start, end, colour);
+			return;
+		}
+
 		set_colour(colour);
 		SDLUtils::SDL_RenderDrawLine(renderer, start, end); // Maybe can use the overloaded version with a colour parameter?
 	}
@@ -35,28 +53,44 @@ namespace Framework {
 	}
 
 	void Graphics::render_poly(const std::vector<vec2> points, const vec2& offset, const Colour& colour) {
-		set_colour(colour);
+		if (!render_queue) set_colour(colour);
 
 		for (uint16_t i = 0; i < points.size(); i++) {
 			// Get next index (for end point)
 			uint8_t next_i = i + 1 < points.size() ? i + 1 : 0;
 
 			// Avoid unnecessary function calls and set_colour calls by using SDL_RenderDrawLine directly
-			SDLUtils::SDL_RenderDrawLine(renderer, points[i] + offset, points[next_i] + offset);
+			if (render_queue) render_queue->line(points[i] + offset, points[next_i] + offset, colour);
+			else SDLUtils::SDL_RenderDrawLine(renderer, points[i] + offset, points[next_i] + offset);
 		}
 	}
 
 	void Graphics::render_rect(const Rect& rect, const Colour& colour) {
+		if (render_queue) {
+			render_queue->rect(rect, colour);
+			return;
+		}
+
 		set_colour(colour);
 		SDLUtils::SDL_RenderDrawRect(renderer, rect);
 	}
 
 	void Graphics::render_filled_rect(const Rect& rect, const Colour& colour) {
+		if (render_queue) {
+			render_queue->fill(rect, colour);
+			return;
+		}
+
 		set_colour(colour);
 		SDLUtils::SDL_RenderFillRect(renderer, rect);
 	}
 
 	void Graphics::render_circle(const vec2& centre, float radius, const Colour& colour) {
+		if (render_queue) {
+			render_queue->circle(centre, radius, colour);
+			return;
+		}
+
 		set_colour(colour);
 		SDLUtils::SDL_RenderDrawCircle(renderer, static_cast<int>(centre.x), static_cast<int>(centre.y), static_cast<int>(radius));
 	}
@@ -69,6 +103,48 @@ namespace Framework {
 		return renderer;
 	}
 
+	void Graphics::set_render_queue(RenderQueue* _render_queue) {
+		render_queue = _render_queue;
+	}
+
+	RenderQueue* Graphics::get_render_queue() {
+		return render_queue;
+	}
+
+	void Graphics::set_render_thread(RenderThread* _render_thread) {
+		render_thread = _render_thread;
+	}
+
+	void Graphics::run_on_renderer(const std::function<void()>& task) {
+		if (render_thread) render_thread->run(task);
+		else task();
+	}
+
+	void Graphics::flush() {
+		if (render_queue) run_on_renderer([this]() { render_queue->submit(); });
+	}
+
+	void Graphics::present() {
+		if (render_thread) {
+			// The frame is drawn from this queue on the render thread, so the next frame is recorded into the other one
+			render_queue = render_thread->present(render_queue);
+
+			// Queue which is returned is the one which was drawn last, and the render thread has finished with it
+			render_statistics = render_queue->take_statistics();
+			return;
+		}
+
+		flush();
+		if (render_queue) render_statistics = render_queue->take_statistics();
+
+		PROFILE_ZONE("SDL_RenderPresent");
+		SDL_RenderPresent(renderer);
+	}
+
+	RenderStatistics Graphics::get_render_statistics() const {
+		return render_statistics;
+	}
+
 	void Graphics::set_colour(const Colour& colour) {
 		SDLUtils::SDL_SetRenderDrawColor(renderer, colour);
 	}
@@ -1,5 +1,7 @@
 #include "Image.hpp"
 
+#include "RenderQueue.hpp"
+
 namespace Framework {
 	Image::Image(Graphics* graphics) {
 		graphics_ptr = graphics;
@@ -20,7 +22,8 @@ namespace Framework {
 		_h = _surface->h;
 
 		// Create texture from image
-		SDL_Texture* temp_texture = SDL_CreateTextureFromSurface(graphics_ptr->get_renderer(), _surface);
+		SDL_Texture* temp_texture = nullptr;
+		graphics_ptr->run_on_renderer([&]() { temp_texture = SDL_CreateTextureFromSurface(graphics_ptr->get_renderer(), _surface); });
 
 		if (temp_texture == NULL)
 		{
@@ -42,7 +45,7 @@ namespace Framework {
 		}
 		else {
 			// Free
-			SDL_DestroyTexture(temp_texture);
+			graphics_ptr->run_on_renderer([&]() { SDL_DestroyTexture(temp_texture); });
 		}
 
 		final_setup();
@@ -111,7 +114,7 @@ namespace Framework {
 			return false;
 		}
 
-		texture = SDL_CreateTexture(graphics_ptr->get_renderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+		graphics_ptr->run_on_renderer([&]() { texture = SDL_CreateTexture(graphics_ptr->get_renderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y); });
 
 		_w = size.x;
 		_h = size.y;
@@ -137,7 +140,9 @@ namespace Framework {
 			types &= ~Flags::SDL_SURFACE; // Unset bit
 		}
 		if (types & Flags::SDL_TEXTURE) {
-			SDL_DestroyTexture(texture);
+			// Anything already recorded from this image has to be drawn before it's destroyed
+			graphics_ptr->flush();
+			graphics_ptr->run_on_renderer([&]() { SDL_DestroyTexture(texture); });
 			types &= ~Flags::SDL_TEXTURE; // Unset bit
 		}
 	}
@@ -151,7 +156,8 @@ namespace Framework {
 			// Check we actually have a surface stored
 			if (types & Flags::SDL_SURFACE) {
 				// Create texture from the stored surface
-				SDL_Texture* temp_texture = SDL_CreateTextureFromSurface(graphics_ptr->get_renderer(), surface);
+				SDL_Texture* temp_texture = nullptr;
+				graphics_ptr->run_on_renderer([&]() { temp_texture = SDL_CreateTextureFromSurface(graphics_ptr->get_renderer(), surface); });
 
 				if (temp_texture == NULL) {
 					printf("Unable to convert surface to texture!\nSDL Error: %s\n", SDL_GetError());
@@ -194,6 +200,11 @@ namespace Framework {
 		if (source_rect.size == vec2{ 0.0f, 0.0f })			source_rect.size = get_size();
 		if (destination_rect.size == vec2{ 0.0f, 0.0f })	destination_rect.size = get_size();
 
+		if (RenderQueue* queue = get_render_queue()) {
+			queue->sprite(this, source_rect, destination_rect, angle, centre, flip);
+			return;
+		}
+
 		SDL_Rect sdl_src_rect = SDLUtils::get_sdl_rect(source_rect);
 		SDL_Rect sdl_dst_rect = SDLUtils::get_sdl_rect(destination_rect);
 
@@ -215,6 +226,11 @@ namespace Framework {
 		if (source_rect.size == vec2{ 0.0f, 0.0f })			source_rect.size = get_size();
 		if (destination_rect.size == vec2{ 0.0f, 0.0f })	destination_rect.size = get_size();
 
+		if (RenderQueue* queue = get_render_queue()) {
+			queue->sprite(this, source_rect, destination_rect, 0.0f, destination_rect.size / 2);
+			return;
+		}
+
 		SDL_Rect sdl_src_rect = SDLUtils::get_sdl_rect(source_rect);
 		SDL_Rect sdl_dst_rect = SDLUtils::get_sdl_rect(destination_rect);
 
@@ -259,13 +275,49 @@ namespace Framework {
 
 
 	void Image::fill(const Colour& colour) {
-		SDLUtils::SDL_RenderFillImageWithAlphaMod(graphics_ptr->get_renderer(), this, colour);
+		// Anything already recorded from this image should be drawn with its old contents
+		graphics_ptr->flush();
+
+		graphics_ptr->run_on_renderer([&]() { SDLUtils::SDL_RenderFillImageWithAlphaMod(graphics_ptr->get_renderer(), this, colour); });
+	}
+
+	void Image::clear() {
+		if (RenderQueue* queue = get_render_queue()) {
+			queue->set_target(this);
+			queue->clear(Colour(0x00, 0x00, 0x00, 0x00));
+			queue->set_target(nullptr);
+			return;
+		}
+
+		SDL_Renderer* renderer = graphics_ptr->get_renderer();
+
+		// Keep old colour and blend mode and set back afterwards
+		Colour old_colour = SDLUtils::SDL_GetRenderDrawColor(renderer);
+		SDL_BlendMode old_blend_mode;
+		SDL_GetRenderDrawBlendMode(renderer, &old_blend_mode);
+
+		// Blending would leave the old contents untouched, since the clear colour is transparent
+		set_render_target();
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+		SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+		SDL_RenderClear(renderer);
+		unset_render_target();
+
+		SDL_SetRenderDrawBlendMode(renderer, old_blend_mode);
+		SDLUtils::SDL_SetRenderDrawColor(renderer, old_colour);
 	}
 
 
 	void Image::set_alpha(uint8_t alpha) {
+		// The alpha is only read when the render queue is submitted, so anything already recorded should be drawn with the old alpha first
+		graphics_ptr->flush();
+
 		if (types & Flags::SDL_SURFACE) SDL_SetSurfaceAlphaMod(surface, alpha);
-		if (types & Flags::SDL_TEXTURE) SDL_SetTextureAlphaMod(texture, alpha);
+		if (types & Flags::SDL_TEXTURE) graphics_ptr->run_on_renderer([&]() { SDL_SetTextureAlphaMod(texture, alpha); });
+	}
+
+	RenderQueue* Image::get_render_queue() {
+		return graphics_ptr->get_render_queue();
 	}
 
 	// Returns SDL_Texture* if loaded, otherwise returns nullptr
@@ -282,10 +334,19 @@ namespace Framework {
 		return vec2{ static_cast<float>(_w), static_cast<float>(_h)};
 	}
 
+	// The change of target is recorded in the render queue if there is one, so that everything recorded goes to the right target
 	void Image::set_render_target() {
+		if (RenderQueue* queue = get_render_queue()) {
+			queue->set_target(this);
+			return;
+		}
 		SDLUtils::SDL_SetRenderTarget(graphics_ptr->get_renderer(), this);
 	}
 	void Image::unset_render_target() {
+		if (RenderQueue* queue = get_render_queue()) {
+			queue->set_target(nullptr);
+			return;
+		}
 		SDLUtils::SDL_UnsetRenderTarget(graphics_ptr->get_renderer());
 	}
 
@@ -311,15 +372,21 @@ namespace Framework {
 	}
 	std::unique_ptr<Image> create_image(Graphics* graphics, const vec2& size, const Colour& colour, bool use_alpha) {
 		std::unique_ptr<Image> image_ptr = create_image(graphics, size);
-		// Fill image white first
-		SDLUtils::SDL_RenderFillRectToImage(graphics->get_renderer(), image_ptr.get(), Rect(VEC_NULL, size), Colour(0xFF, 0xFF, 0xFF));
 
-		if (use_alpha) {
-			SDLUtils::SDL_RenderFillImageWithAlphaMod(graphics->get_renderer(), image_ptr.get(), colour);
-		}
-		else {
-			SDLUtils::SDL_RenderFillImageWithoutAlphaMod(graphics->get_renderer(), image_ptr.get(), colour);
-		}
+		// Changes the render target directly, so anything recorded has to be drawn first
+		graphics->flush();
+
+		graphics->run_on_renderer([&]() {
+			// Fill image white first
+			SDLUtils::SDL_RenderFillRectToImage(graphics->get_renderer(), image_ptr.get(), Rect(VEC_NULL, size), Colour(0xFF, 0xFF, 0xFF));
+
+			if (use_alpha) {
+				SDLUtils::SDL_RenderFillImageWithAlphaMod(graphics->get_renderer(), image_ptr.get(), colour);
+			}
+			else {
+				SDLUtils::SDL_RenderFillImageWithoutAlphaMod(graphics->get_renderer(), image_ptr.get(), colour);
+			}
+		});
 
 		return std::move(image_ptr);
 	}
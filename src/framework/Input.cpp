@@ -7,6 +7,8 @@ namespace Framework {
 
 	// Need to call this before handle_sdl_event
 	void InputHandler::update() {
+		PROFILE_ZONE("InputHandler::update");
+
 		KeyHandler::update(key_data);
 		mouse.update();
 	}
@@ -20,6 +22,10 @@ namespace Framework {
 		KeyHandler::set_key(key_data, key, key_state);
 	}
 
+	KeyHandler::KeyState InputHandler::get_key(KeyHandler::Key key) const {
+		return key_data.key_array[static_cast<int>(key)];
+	}
+
 	bool InputHandler::is_up(KeyHandler::Key key) {
 		KeyHandler::KeyState key_state = key_data.key_array[static_cast<int>(key)];
 		return key_state == KeyHandler::KeyState::STILL_UP || key_state == KeyHandler::KeyState::JUST_RELEASED;
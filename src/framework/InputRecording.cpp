@@ -0,0 +1,147 @@
+#include "InputRecording.hpp"
+
+namespace Framework {
+	InputRecording::InputRecording() {
+		_expected_states.keys = { KeyHandler::KeyState::STILL_UP };
+	}
+
+	InputRecording::InputRecording(uint32_t seed) : InputRecording() {
+		_seed = seed;
+	}
+
+	void InputRecording::record(const InputHandler& input) {
+		for (uint8_t i = 0; i < KeyHandler::KEY_COUNT; i++) {
+			KeyHandler::Key key = static_cast<KeyHandler::Key>(i);
+			KeyHandler::KeyState state = input.get_key(key);
+
+			if (state != _expected_states.key_array[i]) {
+				_changes.push_back({ _update_count, key, state });
+				_expected_states.key_array[i] = state;
+			}
+		}
+
+		// Input is updated between updates, which turns keys which were just pressed or released into held ones, so the replay does the same
+		KeyHandler::update(_expected_states);
+
+		_update_count++;
+	}
+
+	bool InputRecording::replay(InputHandler& input) {
+		if (_next_update == _update_count) return false;
+
+		while (_next_change < _changes.size() && _changes[_next_change].update == _next_update) {
+			input.set_key(_changes[_next_change].key, _changes[_next_change].state);
+			_next_change++;
+		}
+
+		_next_update++;
+		return true;
+	}
+
+	uint32_t InputRecording::get_seed() const {
+		return _seed;
+	}
+
+	uint32_t InputRecording::get_update_count() const {
+		return _update_count;
+	}
+
+	bool InputRecording::save(const std::string& filepath) const {
+		std::ofstream file(filepath, std::ios::binary);
+		if (file.fail()) {
+			printf("Unable to open %s for writing!\n", filepath.c_str());
+			return false;
+		}
+
+		Header header{};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.seed = _seed;
+		header.update_count = _update_count;
+		header.change_count = static_cast<uint32_t>(_changes.size());
+
+		std::vector<uint8_t> data;
+		data.reserve(_changes.size() * 2);
+
+		uint32_t last_update = 0;
+		for (const Change& change : _changes) {
+			uint32_t gap = change.update - last_update;
+			last_update = change.update;
+
+			// Seven bits at a time, with the top bit set on every byte except the last
+			while (gap >= 0x80) {
+				data.push_back(static_cast<uint8_t>(gap | 0x80));
+				gap >>= 7;
+			}
+			data.push_back(static_cast<uint8_t>(gap));
+
+			data.push_back(static_cast<uint8_t>(static_cast<uint8_t>(change.key) << STATE_BITS | static_cast<uint8_t>(change.state)));
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+		if (file.fail()) {
+			printf("Unable to write to %s!\n", filepath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool InputRecording::load(const std::string& filepath) {
+		std::ifstream file(filepath, std::ios::binary);
+		if (file.fail()) {
+			printf("Unable to open %s!\n", filepath.c_str());
+			return false;
+		}
+
+		Header header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		if (file.fail() || header.magic != MAGIC || header.version != VERSION) {
+			printf("%s isn't an input recording, or was made by a different version of the game!\n", filepath.c_str());
+			return false;
+		}
+
+		std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		std::vector<Change> changes;
+		changes.reserve(header.change_count);
+
+		size_t offset = 0;
+		uint32_t update = 0;
+		while (changes.size() < header.change_count) {
+			uint32_t gap = 0;
+			for (uint8_t shift = 0; ; shift += 7) {
+				if (offset == data.size() || shift > 28) {
+					printf("Input recording %s is corrupted!\n", filepath.c_str());
+					return false;
+				}
+
+				uint8_t byte = data[offset++];
+				gap |= static_cast<uint32_t>(byte & 0x7F) << shift;
+				if (!(byte & 0x80)) break;
+			}
+			update += gap;
+
+			if (offset == data.size() || (data[offset] >> STATE_BITS) >= KeyHandler::KEY_COUNT || update >= header.update_count) {
+				printf("Input recording %s is corrupted!\n", filepath.c_str());
+				return false;
+			}
+
+			uint8_t key_state = data[offset++];
+			changes.push_back({
+				update,
+				static_cast<KeyHandler::Key>(key_state >> STATE_BITS),
+				static_cast<KeyHandler::KeyState>(key_state & ((1 << STATE_BITS) - 1))
+			});
+		}
+
+		*this = InputRecording(header.seed);
+		_update_count = header.update_count;
+		_changes = std::move(changes);
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Profiler.hpp"
+
+namespace Framework {
+	Profiler::Zone::Zone(uint32_t zone_id) {
+		_zone_id = zone_id;
+		_start = Clock::now();
+	}
+
+	Profiler::Zone::~Zone() {
+		if (_zone_id == NO_ZONE) return;
+
+		int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start).count();
+		Profiler::get()._current_zone_times[_zone_id].fetch_add(nanoseconds, std::memory_order_relaxed);
+	}
+
+	Profiler::Profiler() {
+		_frame_start = Clock::now();
+	}
+
+	Profiler& Profiler::get() {
+		static Profiler profiler;
+		return profiler;
+	}
+
+	uint32_t Profiler::register_zone(const char* name) {
+		std::lock_guard<std::mutex> lock(_register_mutex);
+
+		uint32_t zone_id = _zone_count.load();
+		if (zone_id == MAX_ZONES) {
+			printf("Unable to profile %s: too many zones!\n", name);
+			return NO_ZONE;
+		}
+
+		// Name is written before the count is increased, so that it's there for anything which sees the new count
+		_zone_names[zone_id] = name;
+		_zone_count.store(zone_id + 1, std::memory_order_release);
+
+		return zone_id;
+	}
+
+	void Profiler::end_frame() {
+		Clock::time_point now = Clock::now();
+
+		Frame& frame = _frames[_next_frame];
+		frame.time = std::chrono::duration<float, std::milli>(now - _frame_start).count();
+
+		for (uint32_t i = 0; i < MAX_ZONES; i++) {
+			frame.zone_times[i] = _current_zone_times[i].exchange(0, std::memory_order_relaxed) / 1e6f;
+		}
+
+		_frame_start = now;
+		_next_frame = (_next_frame + 1) % FRAME_HISTORY;
+		_frame_count = std::min(_frame_count + 1, FRAME_HISTORY);
+	}
+
+	uint32_t Profiler::zone_count() const {
+		return _zone_count.load(std::memory_order_acquire);
+	}
+
+	const char* Profiler::zone_name(uint32_t zone_id) const {
+		return _zone_names[zone_id];
+	}
+
+	Profiler::Stats Profiler::frame_stats() const {
+		return get_stats(NO_ZONE);
+	}
+
+	Profiler::Stats Profiler::zone_stats(uint32_t zone_id) const {
+		return get_stats(zone_id);
+	}
+
+	uint32_t Profiler::frame_count() const {
+		return _frame_count;
+	}
+
+	float Profiler::frame_time(uint32_t index) const {
+		// Oldest frame is the one which will be overwritten next (once the history is full)
+		uint32_t oldest = _frame_count == FRAME_HISTORY ? _next_frame : 0;
+		return _frames[(oldest + index) % FRAME_HISTORY].time;
+	}
+
+	void Profiler::print_report() const {
+		auto print_stats = [](const char* name, const Stats& stats) {
+			printf("  %-20s min: %7.3f ms   avg: %7.3f ms   p99: %7.3f ms\n", name, stats.min, stats.average, stats.p99);
+		};
+
+		printf("Profile of the last %u frames:\n", _frame_count);
+		print_stats("Frame", frame_stats());
+
+		for (uint32_t i = 0; i < zone_count(); i++) {
+			print_stats(zone_name(i), zone_stats(i));
+		}
+	}
+
+	Profiler::Stats Profiler::get_stats(uint32_t zone_id) const {
+		Stats stats;
+		if (_frame_count == 0) return stats;
+
+		float total = 0.0f;
+		for (uint32_t i = 0; i < _frame_count; i++) {
+			float time = zone_id == NO_ZONE ? _frames[i].time : _frames[i].zone_times[zone_id];
+			_sorted_times[i] = time;
+			total += time;
+		}
+
+		auto end = _sorted_times.begin() + _frame_count;
+		auto p99 = _sorted_times.begin() + (_frame_count - 1) * 99 / 100;
+		std::nth_element(_sorted_times.begin(), p99, end);
+
+		stats.min = *std::min_element(_sorted_times.begin(), end);
+		stats.average = total / _frame_count;
+		stats.p99 = *p99;
+
+		return stats;
+	}
+}
\ No newline at end of file
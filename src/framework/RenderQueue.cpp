@@ -0,0 +1,238 @@
+#include "RenderQueue.hpp"
+
+namespace Framework {
+	RenderQueue::RenderQueue() {
+
+	}
+
+	RenderQueue::RenderQueue(Graphics* graphics) : _sprite_batch(graphics) {
+		_graphics = graphics;
+	}
+
+	void RenderQueue::sprite(Image* image, Rect source_rect, Rect destination_rect, float angle, vec2 centre, ImageFlip flip) {
+		add_quad(image->get_texture(), SpriteBatch::get_sprite_vertices(image, source_rect, destination_rect, angle, centre, flip, _colour));
+	}
+
+	void RenderQueue::fill(const Colour& colour) {
+		add_shape(CommandType::FILL_TARGET, colour, VEC_NULL, VEC_NULL, 0.0f, -EVERYWHERE, EVERYWHERE);
+	}
+
+	void RenderQueue::fill(const Rect& rect, const Colour& colour) {
+		// Rounded the same way as Graphics::fill
+		SDL_Rect sdl_rect = SDLUtils::get_sdl_rect(rect);
+
+		float left = static_cast<float>(sdl_rect.x);
+		float top = static_cast<float>(sdl_rect.y);
+		float right = static_cast<float>(sdl_rect.x + sdl_rect.w);
+		float bottom = static_cast<float>(sdl_rect.y + sdl_rect.h);
+
+		SDL_Color sdl_colour = { colour.r, colour.g, colour.b, colour.a };
+
+		add_quad(nullptr, { {
+			{ { left, top }, sdl_colour, { 0.0f, 0.0f } },
+			{ { right, top }, sdl_colour, { 0.0f, 0.0f } },
+			{ { right, bottom }, sdl_colour, { 0.0f, 0.0f } },
+			{ { left, bottom }, sdl_colour, { 0.0f, 0.0f } }
+		} });
+	}
+
+	void RenderQueue::line(const vec2& start, const vec2& end, const Colour& colour) {
+		vec2 bounds_start = vec2{ std::min(start.x, end.x), std::min(start.y, end.y) };
+		vec2 bounds_end = vec2{ std::max(start.x, end.x), std::max(start.y, end.y) };
+
+		add_shape(CommandType::LINE, colour, start, end, 0.0f, bounds_start - SHAPE_MARGIN, bounds_end + SHAPE_MARGIN);
+	}
+
+	void RenderQueue::rect(const Rect& rect, const Colour& colour) {
+		add_shape(CommandType::RECT, colour, rect.position, rect.size, 0.0f, rect.position - SHAPE_MARGIN, rect.position + rect.size + SHAPE_MARGIN);
+	}
+
+	void RenderQueue::circle(const vec2& centre, float radius, const Colour& colour) {
+		vec2 extent = vec2{ radius, radius } + SHAPE_MARGIN;
+		add_shape(CommandType::CIRCLE, colour, centre, VEC_NULL, radius, centre - extent, centre + extent);
+	}
+
+	void RenderQueue::set_colour(const Colour& colour) {
+		_colour = { colour.r, colour.g, colour.b, colour.a };
+	}
+
+	void RenderQueue::set_target(Image* image) {
+		Command command;
+		command.type = CommandType::SET_TARGET;
+		command.texture = image ? image->get_texture() : nullptr;
+
+		// Nothing is ever moved past a change of target, so that everything is drawn to the target it was recorded for
+		command.bounds_start = -EVERYWHERE;
+		command.bounds_end = EVERYWHERE;
+
+		_commands.push_back(command);
+	}
+
+	void RenderQueue::clear(const Colour& colour) {
+		add_shape(CommandType::CLEAR_TARGET, colour, VEC_NULL, VEC_NULL, 0.0f, -EVERYWHERE, EVERYWHERE);
+	}
+
+	void RenderQueue::submit() {
+		if (_commands.empty()) return;
+
+		_batches.clear();
+		_command_batches.resize(_commands.size());
+
+		// Put each command in the latest batch with the same texture which it can be moved back to without drawing over anything it shouldn't
+		for (uint32_t i = 0; i < _commands.size(); i++) {
+			const Command& command = _commands[i];
+
+			uint32_t batch_index = static_cast<uint32_t>(_batches.size());
+
+			if (command.type == CommandType::QUAD) {
+				uint32_t searched = 0;
+
+				for (uint32_t j = static_cast<uint32_t>(_batches.size()); j-- > 0 && searched < MAX_BATCH_LOOKBACK; searched++) {
+					const Batch& batch = _batches[j];
+
+					if (batch.type == CommandType::QUAD && batch.texture == command.texture) {
+						batch_index = j;
+						break;
+					}
+
+					// Anything drawn after this batch which overlaps the command has to stay underneath it
+					if (overlaps(batch.bounds_start, batch.bounds_end, command.bounds_start, command.bounds_end)) break;
+				}
+			}
+
+			if (batch_index == _batches.size()) {
+				_batches.push_back({ command.type, command.texture, command.bounds_start, command.bounds_end });
+			}
+			else {
+				Batch& batch = _batches[batch_index];
+				batch.bounds_start = vec2{ std::min(batch.bounds_start.x, command.bounds_start.x), std::min(batch.bounds_start.y, command.bounds_start.y) };
+				batch.bounds_end = vec2{ std::max(batch.bounds_end.x, command.bounds_end.x), std::max(batch.bounds_end.y, command.bounds_end.y) };
+			}
+
+			_batches[batch_index].count++;
+			_command_batches[i] = batch_index;
+		}
+
+		// Sort the commands by batch (counting sort, so commands in the same batch stay in the order they were recorded)
+		uint32_t first = 0;
+		for (Batch& batch : _batches) {
+			batch.first = first;
+			first += batch.count;
+			batch.count = 0;
+		}
+
+		_order.resize(_commands.size());
+		for (uint32_t i = 0; i < _commands.size(); i++) {
+			Batch& batch = _batches[_command_batches[i]];
+			_order[batch.first + batch.count++] = i;
+		}
+
+		_last_texture = nullptr;
+
+		for (const Batch& batch : _batches) {
+			draw_batch(batch);
+		}
+
+		_commands.clear();
+	}
+
+	RenderStatistics RenderQueue::take_statistics() {
+		RenderStatistics statistics = _statistics;
+		_statistics = RenderStatistics();
+		return statistics;
+	}
+
+	void RenderQueue::add_quad(SDL_Texture* texture, const std::array<SDL_Vertex, 4>& vertices) {
+		Command command;
+		command.type = CommandType::QUAD;
+		command.texture = texture;
+		command.vertices = vertices;
+
+		command.bounds_start = vec2{ vertices[0].position.x, vertices[0].position.y };
+		command.bounds_end = command.bounds_start;
+
+		for (const SDL_Vertex& vertex : vertices) {
+			command.bounds_start = vec2{ std::min(command.bounds_start.x, vertex.position.x), std::min(command.bounds_start.y, vertex.position.y) };
+			command.bounds_end = vec2{ std::max(command.bounds_end.x, vertex.position.x), std::max(command.bounds_end.y, vertex.position.y) };
+		}
+
+		_commands.push_back(command);
+	}
+
+	void RenderQueue::add_shape(CommandType type, const Colour& colour, const vec2& start, const vec2& end, float radius, const vec2& bounds_start, const vec2& bounds_end) {
+		Command command;
+		command.type = type;
+		command.colour = { colour.r, colour.g, colour.b, colour.a };
+		command.start = start;
+		command.end = end;
+		command.radius = radius;
+		command.bounds_start = bounds_start;
+		command.bounds_end = bounds_end;
+
+		_commands.push_back(command);
+	}
+
+	void RenderQueue::draw_batch(const Batch& batch) {
+		SDL_Renderer* renderer = _graphics->get_renderer();
+
+		if (batch.type == CommandType::QUAD) {
+			for (uint32_t i = batch.first; i < batch.first + batch.count; i++) {
+				_sprite_batch.add_quad(batch.texture, _commands[_order[i]].vertices);
+			}
+
+			if (_sprite_batch.flush()) {
+				_statistics.draw_calls++;
+				if (batch.texture != _last_texture) {
+					_statistics.texture_switches++;
+					_last_texture = batch.texture;
+				}
+			}
+			return;
+		}
+
+		// Shapes are never merged, so the batch only has one command
+		const Command& command = _commands[_order[batch.first]];
+
+		SDL_SetRenderDrawColor(renderer, command.colour.r, command.colour.g, command.colour.b, command.colour.a);
+
+		if (command.type != CommandType::SET_TARGET) _statistics.draw_calls++;
+
+		switch (command.type) {
+		case CommandType::FILL_TARGET:
+			// NULL means draw rect over whole renderer
+			SDL_RenderFillRect(renderer, NULL);
+			break;
+
+		case CommandType::CLEAR_TARGET:
+			SDL_RenderClear(renderer);
+			break;
+
+		case CommandType::SET_TARGET:
+			if (SDL_SetRenderTarget(renderer, command.texture)) {
+				printf("Unable to set render target to texture!\nSDL Error: %s\n", SDL_GetError());
+				SDL_ClearError();
+			}
+			break;
+
+		case CommandType::LINE:
+			SDLUtils::SDL_RenderDrawLine(renderer, command.start, command.end);
+			break;
+
+		case CommandType::RECT:
+			SDLUtils::SDL_RenderDrawRect(renderer, Rect(command.start, command.end));
+			break;
+
+		case CommandType::CIRCLE:
+			SDLUtils::SDL_RenderDrawCircle(renderer, static_cast<int>(command.start.x), static_cast<int>(command.start.y), static_cast<int>(command.radius));
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	bool RenderQueue::overlaps(const vec2& a_start, const vec2& a_end, const vec2& b_start, const vec2& b_end) {
+		// Rects which only share an edge don't overlap, so neighbouring tiles can still be reordered
+		return a_start.x < b_end.x && b_start.x < a_end.x && a_start.y < b_end.y && b_start.y < a_end.y;
+	}
+}
\ No newline at end of file
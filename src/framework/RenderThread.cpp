@@ -0,0 +1,102 @@
+#include "RenderThread.hpp"
+
+namespace Framework {
+	RenderThread::RenderThread(Graphics* graphics, SDL_Window* window, RenderQueue* spare_queue) {
+		_graphics = graphics;
+		_window = window;
+		_free_queue = spare_queue;
+
+		// An OpenGL context can only be current on one thread at a time, so it's released here for the render thread to take over
+		// SDL makes the context current again whenever the renderer is used on a different thread (does nothing for other renderers)
+		if (SDL_GL_GetCurrentContext()) SDL_GL_MakeCurrent(_window, nullptr);
+
+		_thread = std::thread(&RenderThread::loop, this);
+	}
+
+	RenderThread::~RenderThread() {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			wait_until_idle(lock);
+			_stopping = true;
+		}
+		_work_ready.notify_one();
+
+		_thread.join();
+	}
+
+	RenderQueue* RenderThread::present(RenderQueue* frame) {
+		RenderQueue* next_queue = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			wait_until_idle(lock);
+
+			// The previous frame has been drawn, so its queue is empty again
+			next_queue = _free_queue;
+			_free_queue = frame;
+			_frame = frame;
+		}
+		_work_ready.notify_one();
+
+		return next_queue;
+	}
+
+	void RenderThread::run(const std::function<void()>& task) {
+		if (std::this_thread::get_id() == _thread.get_id()) {
+			task();
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		wait_until_idle(lock);
+
+		_task = &task;
+		_work_ready.notify_one();
+
+		// task is only referenced, so it has to stay alive until it's finished
+		_work_done.wait(lock, [this]() { return _task == nullptr; });
+	}
+
+	void RenderThread::loop() {
+		SDL_Renderer* renderer = _graphics->get_renderer();
+
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		while (true) {
+			_work_ready.wait(lock, [this]() { return _stopping || _frame || _task; });
+
+			if (_task) {
+				lock.unlock();
+				(*_task)();
+				lock.lock();
+
+				_task = nullptr;
+			}
+			else if (_frame) {
+				lock.unlock();
+				_frame->submit();
+				{
+					PROFILE_ZONE("SDL_RenderPresent");
+					SDL_RenderPresent(renderer);
+				}
+				lock.lock();
+
+				_frame = nullptr;
+			}
+			else {
+				break;
+			}
+
+			_work_done.notify_one();
+		}
+
+		lock.unlock();
+
+		// Hand the OpenGL context back, so that the renderer can be used on the main thread again
+		if (SDL_GL_GetCurrentContext()) SDL_GL_MakeCurrent(_window, nullptr);
+	}
+
+	void RenderThread::wait_until_idle(std::unique_lock<std::mutex>& lock) {
+		_work_done.wait(lock, [this]() { return _frame == nullptr && _task == nullptr; });
+	}
+}
\ No newline at end of file
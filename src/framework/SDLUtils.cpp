@@ -2,7 +2,12 @@
 
 namespace Framework::SDLUtils {
 
-	bool init_sdl(SDL_Window*& window, SDL_Renderer*& renderer, const std::string& title, const vec2& size) {
+	bool init_sdl(SDL_Window*& window, SDL_Renderer*& renderer, const std::string& title, const vec2& size, bool headless) {
+		// Works without a display, e.g. on a CI machine
+		if (headless) {
+			SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+		}
+
 		// Initialise SDL
 		if (SDL_Init(SDL_INIT_VIDEO) < 0)
 		{
@@ -32,11 +37,11 @@ namespace Framework::SDLUtils {
 			SDL_WINDOWPOS_UNDEFINED,
 			size.x,
 			size.y,
-			SDL_WINDOW_SHOWN // Not sure if this is needed: it could be 0 instead?
+			headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN // Not sure if this is needed: it could be 0 instead?
 		);
 
 		// Create renderer for window
-		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+		renderer = SDL_CreateRenderer(window, -1, headless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED);
 
 		// Set renderer mode
 		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
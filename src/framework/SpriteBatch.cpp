@@ -0,0 +1,94 @@
+#include "SpriteBatch.hpp"
+
+namespace Framework {
+	SpriteBatch::SpriteBatch() {
+
+	}
+
+	SpriteBatch::SpriteBatch(Graphics* graphics) {
+		_graphics = graphics;
+	}
+
+	void SpriteBatch::add(Image* image, Rect source_rect, Rect destination_rect, float angle, vec2 centre, ImageFlip flip) {
+		add_quad(image->get_texture(), get_sprite_vertices(image, source_rect, destination_rect, angle, centre, flip, _colour));
+	}
+
+	void SpriteBatch::add_quad(SDL_Texture* texture, const std::array<SDL_Vertex, 4>& vertices) {
+		if (texture != _texture) {
+			flush();
+			_texture = texture;
+		}
+
+		int first_index = static_cast<int>(_vertices.size());
+
+		_vertices.insert(_vertices.end(), vertices.begin(), vertices.end());
+
+		// Two triangles per quad
+		for (int index : { 0, 1, 2, 2, 3, 0 }) {
+			_indices.push_back(first_index + index);
+		}
+	}
+
+	void SpriteBatch::set_colour(const Colour& colour) {
+		_colour = { colour.r, colour.g, colour.b, colour.a };
+	}
+
+	bool SpriteBatch::flush() {
+		if (_indices.empty()) return false;
+
+		SDL_RenderGeometry(_graphics->get_renderer(), _texture, _vertices.data(), static_cast<int>(_vertices.size()), _indices.data(), static_cast<int>(_indices.size()));
+
+		_vertices.clear();
+		_indices.clear();
+		return true;
+	}
+
+	std::array<SDL_Vertex, 4> SpriteBatch::get_sprite_vertices(Image* image, Rect source_rect, Rect destination_rect, float angle, vec2 centre, ImageFlip flip, SDL_Color colour) {
+		// Rounded the same way as Image::render, so that batched sprites line up exactly with everything else
+		SDL_Rect dst = SDLUtils::get_sdl_rect(destination_rect);
+		SDL_Point sdl_centre = SDLUtils::get_sdl_point(centre);
+
+		// Texture coordinates of the corners of the sprite
+		vec2 image_size = image->get_size();
+		float u0 = source_rect.position.x / image_size.x;
+		float v0 = source_rect.position.y / image_size.y;
+		float u1 = (source_rect.position.x + source_rect.size.x) / image_size.x;
+		float v1 = (source_rect.position.y + source_rect.size.y) / image_size.y;
+
+		if (flip & ImageFlip::FLIP_HORIZONTAL) std::swap(u0, u1);
+		if (flip & ImageFlip::FLIP_VERTICAL) std::swap(v0, v1);
+
+		// Rotated clockwise about the centre (relative to the top left of the sprite), like SDL_RenderCopyEx
+		float radians = angle * std::numbers::pi_v<float> / 180.0f;
+		float c = std::cos(radians);
+		float s = std::sin(radians);
+
+		float w = static_cast<float>(dst.w);
+		float h = static_cast<float>(dst.h);
+
+		const std::array<std::pair<vec2, SDL_FPoint>, 4> corners = { {
+			{ { 0.0f, 0.0f }, { u0, v0 } },
+			{ { w, 0.0f }, { u1, v0 } },
+			{ { w, h }, { u1, v1 } },
+			{ { 0.0f, h }, { u0, v1 } }
+		} };
+
+		std::array<SDL_Vertex, 4> vertices;
+
+		for (uint8_t i = 0; i < 4; i++) {
+			const auto& [corner, tex_coord] = corners[i];
+
+			float x = corner.x - sdl_centre.x;
+			float y = corner.y - sdl_centre.y;
+
+			SDL_FPoint position = {
+				dst.x + sdl_centre.x + x * c - y * s,
+				dst.y + sdl_centre.y + x * s + y * c
+			};
+
+			vertices[i] = { position, colour, tex_coord };
+		}
+
+		return vertices;
+	}
+}
\ No newline at end of file
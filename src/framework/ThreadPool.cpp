@@ -0,0 +1,49 @@
+#include "ThreadPool.hpp"
+
+namespace Framework {
+	ThreadPool::ThreadPool(uint32_t thread_count) {
+		if (thread_count == 0) {
+			// hardware_concurrency() can return 0 if the number of cores isn't known
+			uint32_t cores = std::thread::hardware_concurrency();
+			thread_count = cores > 1 ? cores - 1 : 1;
+		}
+
+		for (uint32_t i = 0; i < thread_count; i++) {
+			_threads.emplace_back(&ThreadPool::run, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_condition.notify_all();
+
+		for (std::thread& thread : _threads) {
+			thread.join();
+		}
+	}
+
+	uint32_t ThreadPool::thread_count() {
+		return static_cast<uint32_t>(_threads.size());
+	}
+
+	void ThreadPool::run(uint32_t thread_index) {
+		while (true) {
+			std::function<void(uint32_t)> task;
+
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+
+				if (_stopping) return;
+
+				task = std::move(_tasks.front());
+				_tasks.pop();
+			}
+
+			task(thread_index);
+		}
+	}
+}
\ No newline at end of file
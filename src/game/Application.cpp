@@ -6,7 +6,7 @@ int main(int argc, char* argv[]) {
 	Game game;
 	
 	// Run game
-	game.run();
+	game.run(Framework::LaunchOptions::parse(argc, argv));
 	
 	return 0;
 }
\ No newline at end of file
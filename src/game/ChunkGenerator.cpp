@@ -0,0 +1,193 @@
+#include "ChunkGenerator.hpp"
+
+ChunkGenerator::ChunkGenerator(TerrainRules _terrain_rules, uint32_t _seed)
+	: seed(_seed)
+	, terrain_rules(std::move(_terrain_rules))
+	, seam_solver(GAME::SEAM_SOLVE_WIDTH, GAME::CHUNK_TILE_HEIGHT, terrain_rules) {
+	non_rail_options = terrain_rules.options.all;
+	std::erase_if(non_rail_options, [this](uint32_t o) { return std::find(terrain_rules.options.rail.begin(), terrain_rules.options.rail.end(), o) != terrain_rules.options.rail.end(); });
+
+	// The first chunk's rail starts off flat
+	for (uint8_t i = 0; i < 2; i++) {
+		last_plan.rail_heights.emplace_back(GAME::CHUNK_TILE_HEIGHT / 2, RailDirection::NONE); // TODO: maybe pick more intelligently
+	}
+}
+
+TerrainRules ChunkGenerator::load_terrain_rules(std::string base_path, std::string executable_path) {
+#ifdef COMPILED_TERRAIN_RULES
+	// Rules are built into the game, so there's nothing to load
+	return TerrainRules();
+#else
+	// Prefer the compiled rule pack, but fall back to the JSON rules if it hasn't been built
+	// The build puts the rule pack next to the executable, and installs put it with the rest of the level data
+	for (const std::string& path : { executable_path, base_path }) {
+		if (path.empty()) continue;
+
+		std::string rule_pack_path = path + PATHS::LEVEL_DATA::LOCATION + PATHS::LEVEL_DATA::TERRAIN_GENERATION_RULE_PACK;
+		if (std::filesystem::exists(rule_pack_path)) return WaveFunctionCollapse::load_rule_pack(rule_pack_path);
+	}
+
+	return WaveFunctionCollapse::load_rules(base_path + PATHS::LEVEL_DATA::LOCATION + PATHS::LEVEL_DATA::TERRAIN_GENERATION_DATA);
+#endif
+}
+
+ChunkGenerator::ChunkPlan ChunkGenerator::plan_next_chunk() {
+	ChunkPlan plan;
+	plan.chunk_id = next_chunk_id++;
+	plan.left_seam = last_plan.right_seam;
+
+	// Attempt 0 is used for planning, and the rest for generating the terrain
+	SplitMix random(seed, plan.chunk_id, 0);
+
+	// Carry on from the end of the previous chunk's rail
+	for (uint8_t i = 0; i < 2; i++) {
+		plan.rail_heights.push_back(last_plan.rail_heights.at(i + last_plan.rail_heights.size() - 2));
+	}
+
+	for (uint8_t x = 2; x < GAME::CHUNK_TILE_WIDTH + 2; x++) {
+		// Generate a path for the rail
+		// Do this by selecting a direction to travel in each frame
+		auto [previous_rail_height, previous_rail_direction] = plan.rail_heights.at(plan.rail_heights.size() - 1);
+		uint32_t new_rail_height = previous_rail_height;
+		float value = random.random();
+
+		// TODO: make these constants?
+		if (value < 0.25f && previous_rail_direction != RailDirection::DOWN && previous_rail_height > 12) {
+			// Go up, but only if wasn't just going down
+			new_rail_height--;
+			previous_rail_direction = RailDirection::UP;
+		}
+		else if (0.25f <= value && value < 0.5f && previous_rail_direction != RailDirection::UP && previous_rail_height < 20) {
+			// Go down, but only if wasn't just going up
+			new_rail_height++;
+			previous_rail_direction = RailDirection::DOWN;
+		}
+		else {
+			// Go straight
+			previous_rail_direction = RailDirection::NONE;
+		}
+		plan.rail_heights.emplace_back(new_rail_height, previous_rail_direction);
+	}
+
+	// Solve the seam (the chunk's last column) along with the columns either side of it
+	// Only the seam is kept: the other columns are solved again when the chunks are generated
+	uint8_t first_column = GAME::CHUNK_TILE_WIDTH + 2 - GAME::SEAM_SOLVE_WIDTH;
+	uint8_t seam_column = GAME::CHUNK_TILE_WIDTH - first_column;
+
+	seam_solver.reset();
+	constrain_terrain(seam_solver, plan.rail_heights, first_column, GAME::SEAM_SOLVE_WIDTH);
+
+	// Rail tiles crossing the seam anywhere except the rail path are hard to join up to, so don't allow them
+	for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
+		if (!seam_solver.is_cell_collapsed(seam_column, y)) seam_solver.set_cell(seam_column, y, non_rail_options);
+	}
+
+	// If this fails, the chunks either side just won't be constrained by the tiles which weren't solved
+	seam_solver.collapse(random);
+
+	for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
+		plan.right_seam[y] = seam_solver.get_cell(seam_column, y);
+	}
+
+	last_plan = plan;
+	return plan;
+}
+
+ChunkGenerator::Chunk ChunkGenerator::generate_chunk(const ChunkPlan& plan, TerrainSolver& solver) const {
+	Chunk chunk;
+	TerrainSolver::Statistics solver_statistics;
+
+	for (uint32_t attempt = 1; attempt <= GAME::MAX_CHUNK_ATTEMPTS; attempt++) {
+		// If this fails, just try again with different random numbers
+		// Whatever is left after the last attempt is used anyway
+		chunk = generate_chunk_attempt(plan, attempt, solver);
+		solver_statistics += chunk.statistics.solver;
+		if (chunk.statistics.complete || chunk.statistics.unsolvable) break;
+	}
+
+	chunk.statistics.solver = solver_statistics;
+	return chunk;
+}
+
+ChunkGenerator::Chunk ChunkGenerator::generate_chunk_attempt(const ChunkPlan& plan, uint32_t attempt, TerrainSolver& solver) const {
+	Chunk chunk;
+	chunk.chunk_id = plan.chunk_id;
+	chunk.rail_heights = plan.rail_heights;
+	chunk.statistics.attempts = attempt;
+
+	if (DEBUG::LOG_GENERATION) std::cout << "Chunk " << plan.chunk_id << " attempt: " << attempt << std::endl;
+
+	// Reset grid stored within the wavefront solver
+	solver.reset();
+
+	// NOTE: alternative idea: generate terrain, then fit rail to it on a second pass?
+	constrain_terrain(solver, plan.rail_heights, 0, GAME::CHUNK_TILE_WIDTH + 2);
+
+	// Join onto the seams either side, which were solved when the chunk was planned
+	for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
+		if (plan.left_seam[y]) solver.set_cell(0, y, plan.left_seam[y].value());
+		if (plan.right_seam[y]) solver.set_cell(GAME::CHUNK_TILE_WIDTH, y, plan.right_seam[y].value());
+	}
+
+	// Each attempt has its own stream, so the result doesn't depend on which order the chunks are generated in
+	SplitMix random(seed, plan.chunk_id, attempt);
+
+	chunk.statistics.complete = solver.collapse(random, 0);
+	chunk.statistics.solver = solver.get_statistics();
+	chunk.statistics.unsolvable = !chunk.statistics.complete && chunk.statistics.solver.decisions == 0;
+
+	// Copy data from solver to chunk
+	// Don't copy leftmost column, since that's used to stitch together the chunks
+	// TEMP: put coins in incomplete cells
+	for (uint8_t x = 0; x < GAME::CHUNK_TILE_WIDTH; x++) {
+		for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
+			chunk.chunk_grid[x][y] = 144;
+			if (auto value = solver.get_cell(x + 1, y)) {
+				chunk.chunk_grid[x][y] = value.value();
+			}
+		}
+	}
+
+	return chunk;
+}
+
+std::unique_ptr<ChunkGenerator::TerrainSolver> ChunkGenerator::create_terrain_solver() const {
+	return std::make_unique<TerrainSolver>(
+		// Add 1 tiles to the left side to allow chunks to be stitched together
+		// Add 2 tiles to the right side to ensure a valid chunk is generated (ensure it is continuable)
+		GAME::CHUNK_TILE_WIDTH + 2, GAME::CHUNK_TILE_HEIGHT,
+		terrain_rules
+	);
+}
+
+const TerrainRules& ChunkGenerator::get_terrain_rules() const {
+	return terrain_rules;
+}
+
+void ChunkGenerator::constrain_terrain(TerrainSolver& solver, const RailHeights& rail_heights, uint8_t first_column, uint8_t column_count) const {
+	for (uint8_t x = 0; x < column_count; x++) {
+		// Don't allow rails on the very bottom line
+		solver.set_cell(x, GAME::CHUNK_TILE_HEIGHT - 1, non_rail_options);
+	}
+
+	for (uint8_t x = 0; x < column_count; x++) {
+		auto [height, direction] = rail_heights.at(first_column + x);
+
+		// TODO: change to list of options
+		uint32_t index;
+		switch (direction) {
+		case RailDirection::NONE:
+		default:
+			index = 133;
+			break;
+		case RailDirection::UP:
+			index = 187;
+			height++;
+			break;
+		case RailDirection::DOWN:
+			index = 188;
+			break;
+		}
+		solver.set_cell(x, height, index);
+	}
+}
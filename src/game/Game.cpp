@@ -5,7 +5,17 @@ Game::Game() : BaseGame() {
 }
 
 void Game::start() {
-	stage = new IntroStage();
+	if (!launch_options.record_path.empty() || !launch_options.replay_path.empty()) {
+		// Start the ride straight away, so that replays don't depend on clicking through the menus (which aren't recorded)
+		stage = new GameStage(launch_options.seed, true);
+	}
+	else if (launch_options.headless) {
+		// Skip the menus, since there's no one to click through them
+		stage = new SimulationStage(launch_options.rides, launch_options.seed);
+	}
+	else {
+		stage = new IntroStage();
+	}
 }
 
 void Game::end() {
@@ -18,6 +28,13 @@ void Game::load_data() {
 	
 	graphics_objects.base_path = BASE_PATH;
 
+	// Files generated by the build (such as the rule pack) are put next to the executable, rather than in the source tree
+	char* executable_path = SDL_GetBasePath();
+	if (executable_path) {
+		graphics_objects.executable_path = executable_path;
+		SDL_free(executable_path);
+	}
+
 	// Base path is two above images path
 	std::string IMAGES_PATH = BASE_PATH + PATHS::IMAGES::LOCATION;
 
@@ -64,7 +81,8 @@ void Game::load_data() {
 	graphics_objects.button_image_groups[GRAPHICS_OBJECTS::BUTTON_IMAGE_GROUPS::STANDARD].selected->set_render_target();
 	graphics_objects.spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::BUTTON_SPRITESHEET].rect(Framework::Rect(0, 32, 64, 16), Framework::Vec(0, 0), 1.0f);
 
-	Framework::SDLUtils::SDL_UnsetRenderTarget(graphics_objects.graphics.get_renderer());
+	// Unset through the image, so that the button recorded in the render queue is drawn to it first
+	graphics_objects.button_image_groups[GRAPHICS_OBJECTS::BUTTON_IMAGE_GROUPS::STANDARD].selected->unset_render_target();
 
 
 	// Create transitions
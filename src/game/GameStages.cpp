@@ -2,6 +2,11 @@
 
 // GameStage
 
+GameStage::GameStage(uint32_t seed, bool deterministic) : BaseStage() {
+	_seed = seed;
+	_deterministic = deterministic;
+}
+
 void GameStage::start() {
 	// Set transition
 	set_transition(graphics_objects->transition_ptrs[GRAPHICS_OBJECTS::TRANSITIONS::FADE_TRANSITION].get());
@@ -14,7 +19,7 @@ void GameStage::start() {
 
 		// Create Player and Hud instances
 		player = Player(graphics_objects);
-		level.emplace(graphics_objects, 0); // TODO: change seed, e.g. to level number? or randomly generated
+		level.emplace(graphics_objects, _seed, _deterministic); // TODO: change seed, e.g. to level number? or randomly generated
 		hud = Hud(graphics_objects);
 	}
 }
@@ -22,10 +27,15 @@ void GameStage::start() {
 bool GameStage::update(float dt) {
 	transition->update(dt);
 
-	level->update(dt, player->get_position(), input);
+	level->update(dt, player->get_position(), player->get_velocity(), input);
 	player->update(dt, input, level.value());
 	hud->update(dt);
 
+	// Performance overlay
+	if (input->just_down(Framework::KeyHandler::Key::O)) {
+		hud->toggle_overlay();
+	}
+
 	if (input->just_down(Framework::KeyHandler::Key::ESCAPE) || input->just_down(Framework::KeyHandler::Key::P)) {
 		finish(new PausedStage(this), false);
 	}
@@ -33,14 +43,14 @@ bool GameStage::update(float dt) {
 	return true;
 }
 
-void GameStage::render() {
+void GameStage::render(float alpha) {
 	graphics_objects->graphics.fill(COLOURS::BLUE);
 
 	//graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(0, Framework::Vec(128, 64));
 
-	level->render();
-	player->render();
-	hud->render(player.value());
+	level->render(alpha);
+	player->render(alpha);
+	hud->render(player.value(), level.value());
 
 	transition->render();
 }
@@ -107,9 +117,10 @@ bool PausedStage::update(float dt) {
 	return true;
 }
 
-void PausedStage::render() {
+void PausedStage::render(float) {
 	// Render background stage
-	_background_stage->render();
+	// It isn't being updated, so its latest state is drawn rather than interpolating towards it
+	_background_stage->render(1.0f);
 
 	// Render pause menu
 	graphics_objects->graphics.fill(COLOURS::BLACK, 0x7f);
@@ -119,4 +130,104 @@ void PausedStage::render() {
 	}
 
 	transition->render();
+}
+
+// SimulationStage
+
+SimulationStage::SimulationStage(uint32_t ride_count, uint32_t first_seed) : BaseStage() {
+	_ride_count = ride_count;
+	_first_seed = first_seed;
+}
+
+void SimulationStage::start() {
+	printf("Simulating %u rides, starting with seed %u\n", _ride_count, _first_seed);
+
+	start_time = Clock::now();
+
+	if (_ride_count) start_ride();
+}
+
+bool SimulationStage::update(float dt) {
+	if (ride_index == _ride_count) {
+		print_results();
+		return false;
+	}
+
+	// Scripted input, so that every ride with the same seed goes the same way
+	float time = ride_ticks * dt;
+	bool accelerate = std::fmod(time, SIMULATION::ACCELERATE_TIME + SIMULATION::COAST_TIME) < SIMULATION::ACCELERATE_TIME;
+	input->set_key(Framework::KeyHandler::Key::RIGHT, accelerate ? Framework::KeyHandler::KeyState::STILL_DOWN : Framework::KeyHandler::KeyState::STILL_UP);
+
+	// Same as GameStage::update, but timed
+	Clock::time_point level_start = Clock::now();
+	level->update(dt, player->get_position(), player->get_velocity(), input);
+
+	Clock::time_point player_start = Clock::now();
+	player->update(dt, input, level.value());
+
+	Clock::time_point player_end = Clock::now();
+	level_update_seconds += std::chrono::duration<double>(player_start - level_start).count();
+	player_update_seconds += std::chrono::duration<double>(player_end - player_start).count();
+
+	ride_ticks++;
+	total_ticks++;
+
+	// Player has fallen off the bottom of the screen
+	bool crashed = player->get_position().y > GAME::CHUNK_HEIGHT;
+
+	if (crashed || ride_ticks * dt >= SIMULATION::RIDE_TIME) {
+		finish_ride(crashed);
+	}
+
+	return true;
+}
+
+void SimulationStage::render(float) {
+	// Never called, since nothing is drawn in headless mode
+}
+
+void SimulationStage::start_ride() {
+	ride_ticks = 0;
+
+	level.emplace(graphics_objects, _first_seed + ride_index, true, true);
+	player = Player(graphics_objects);
+}
+
+void SimulationStage::finish_ride(bool crashed) {
+	Framework::vec2 position = player->get_position();
+	float distance = position.x - GAME::PLAYER::STARTING_POSITION.x;
+
+	printf("Ride %u (seed %u): %s after %.2fs, distance %.1f\n", ride_index, _first_seed + ride_index, crashed ? "crashed" : "finished", ride_ticks * WINDOW::UPDATE_DT, distance);
+
+	if (crashed) crashes++;
+	total_distance += distance;
+
+	// FNV-1a of the exact final position
+	for (float value : { position.x, position.y }) {
+		uint32_t bits = std::bit_cast<uint32_t>(value);
+		for (uint8_t i = 0; i < 4; i++) {
+			checksum = (checksum ^ ((bits >> (i * 8)) & 0xFF)) * 1099511628211ull;
+		}
+	}
+
+	// Wait for this ride's workers to stop before the next ride starts its own
+	level.reset();
+
+	ride_index++;
+	if (ride_index < _ride_count) {
+		start_ride();
+	}
+}
+
+void SimulationStage::print_results() {
+	double seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+	double game_seconds = total_ticks * WINDOW::UPDATE_DT;
+	double ticks = std::max(total_ticks, uint64_t(1));
+
+	printf("Simulated %u rides (%llu updates, %.1fs of game time) in %.2fs\n", _ride_count, static_cast<unsigned long long>(total_ticks), game_seconds, seconds);
+	printf("  %.0f updates per second (%.1fx real time)\n", total_ticks / seconds, game_seconds / seconds);
+	printf("  Level::update:  %8.2f us per update (including waiting for chunks)\n", level_update_seconds * 1e6 / ticks);
+	printf("  Player::update: %8.2f us per update\n", player_update_seconds * 1e6 / ticks);
+	printf("  Crashes: %u, average distance: %.1f\n", crashes, _ride_count ? total_distance / _ride_count : 0.0);
+	printf("  Checksum: %016llx\n", static_cast<unsigned long long>(checksum));
 }
\ No newline at end of file
@@ -14,24 +14,91 @@ Hud::Hud(Framework::GraphicsObjects* _graphics_objects)
 	};
 	// Create animation handler
 	heart = std::make_unique<Framework::AnimationHandler>(graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET], heart_animation);
-
-
-	// Create fps text
-	fps_text = Framework::Text(&graphics_objects->fonts[GRAPHICS_OBJECTS::FONTS::MAIN_FONT], "", COLOURS::BLACK, 2);
-
 }
 
 void Hud::update(float dt) {
 	heart->update(dt);
-
-	uint32_t fps = static_cast<uint32_t>(1.0f / dt);
-	fps_text.set_text(std::to_string(fps));
 }
 
-void Hud::render(const Player& player) {
+void Hud::render(const Player& player, const Level& level) {
+	PROFILE_ZONE("Hud::render");
+
 	for (uint8_t i = 0; i < player.get_health(); i++) {
 		heart->render(Framework::Vec(4 + i * SPRITES::SIZE, 4));
 	}
 
-	//fps_text.render({ 2, 0 }, Framework::Font::AnchorPosition::TOP_LEFT);
+	if (show_overlay) {
+		render_overlay(level);
+	}
+}
+
+void Hud::toggle_overlay() {
+	show_overlay = !show_overlay;
+}
+
+void Hud::render_overlay(const Level& level) {
+	Framework::Graphics& graphics = graphics_objects->graphics;
+
+	// Work out the height first, so that the background can be drawn underneath everything
+	// Three lines of render and chunk statistics, and either the frame and zone timings or a line saying there aren't any
+	uint32_t line_count = 3;
+#ifdef PROFILER_ENABLED
+	const Framework::Profiler& profiler = Framework::Profiler::get();
+	line_count += 2 + profiler.zone_count();
+#else
+	line_count += 1;
+#endif
+
+	float height = OVERLAY::PADDING * 2 + line_count * OVERLAY::LINE_HEIGHT;
+#ifdef PROFILER_ENABLED
+	height += OVERLAY::GRAPH_HEIGHT + OVERLAY::PADDING;
+#endif
+
+	Framework::vec2 corner = Framework::vec2{ WINDOW::SIZE.x - OVERLAY::WIDTH - OVERLAY::PADDING, OVERLAY::PADDING };
+	graphics.fill(Framework::Rect(corner, Framework::vec2{ OVERLAY::WIDTH, height }), COLOURS::BLACK, OVERLAY::BACKGROUND_ALPHA);
+
+	Framework::vec2 position = corner + Framework::vec2{ OVERLAY::PADDING, OVERLAY::PADDING };
+
+#ifdef PROFILER_ENABLED
+	Framework::Profiler::Stats frame_stats = profiler.frame_stats();
+	render_overlay_line(position, "FPS: %.0f (%.2f ms avg, %.2f ms p99)", frame_stats.average > 0.0f ? 1000.0f / frame_stats.average : 0.0f, frame_stats.average, frame_stats.p99);
+
+	// Frame time graph, oldest frame on the left
+	float graph_width = OVERLAY::WIDTH - OVERLAY::PADDING * 2;
+	float bar_width = graph_width / Framework::Profiler::FRAME_HISTORY;
+	float graph_bottom = position.y + OVERLAY::GRAPH_HEIGHT;
+	float target_time = WINDOW::TARGET_DT * 1000.0f;
+
+	for (uint32_t i = 0; i < profiler.frame_count(); i++) {
+		float time = profiler.frame_time(i);
+		float bar_height = std::min(time / OVERLAY::GRAPH_MAX_TIME, 1.0f) * OVERLAY::GRAPH_HEIGHT;
+
+		// Frames are timed from the end of the last one, so a frame which only just makes the target can be a little over it
+		const Framework::Colour& colour = time > target_time * 1.05f ? COLOURS::RED : COLOURS::WHITE;
+		graphics.fill(Framework::Rect(position.x + i * bar_width, graph_bottom - bar_height, bar_width, bar_height), colour);
+	}
+
+	// Line at the target frame time
+	float target_y = graph_bottom - target_time / OVERLAY::GRAPH_MAX_TIME * OVERLAY::GRAPH_HEIGHT;
+	graphics.render_line(Framework::vec2{ position.x, target_y }, Framework::vec2{ position.x + graph_width, target_y }, COLOURS::GREY);
+
+	position.y = graph_bottom + OVERLAY::PADDING;
+
+	// Zone timings
+	render_overlay_line(position, "%-22s %7s %7s %7s", "Zone (ms)", "min", "avg", "p99");
+	for (uint32_t i = 0; i < profiler.zone_count(); i++) {
+		Framework::Profiler::Stats stats = profiler.zone_stats(i);
+		render_overlay_line(position, "%-22s %7.3f %7.3f %7.3f", profiler.zone_name(i), stats.min, stats.average, stats.p99);
+	}
+#else
+	render_overlay_line(position, "Profiler is compiled out of this build");
+#endif
+
+	Framework::RenderStatistics render_statistics = graphics.get_render_statistics();
+	render_overlay_line(position, "Draw calls: %u, texture switches: %u", render_statistics.draw_calls, render_statistics.texture_switches);
+
+	render_overlay_line(position, "Chunks: %u loaded, %u queued", level.get_loaded_chunk_count(), level.get_planned_chunk_count());
+
+	const ChunkGenerator::ChunkStatistics& chunk_statistics = level.get_last_chunk_statistics();
+	render_overlay_line(position, "Chunk %u: %u backtracks, %u restarts, %u attempts", level.get_last_chunk_id(), chunk_statistics.solver.backtracks, chunk_statistics.solver.restarts, chunk_statistics.attempts);
 }
@@ -1,27 +1,38 @@
 #include "Level.hpp"
 
-Level::Level(Framework::GraphicsObjects* _graphics_objects, uint32_t _seed)
+Level::Level(Framework::GraphicsObjects* _graphics_objects, uint32_t _seed, bool _wait_for_generation, bool _headless)
 	: graphics_objects(_graphics_objects)
 	, seed(_seed)
-	, random(_seed)
-	, wfc(WaveFunctionCollapse::create_from_file(
-		// Add 1 tiles to the left side to allow chunks to be stitched together
-		// Add 2 tiles to the right side to ensure a valid chunk is generated (ensure it is continuable)
-		GAME::CHUNK_TILE_WIDTH + 2, GAME::CHUNK_TILE_HEIGHT,
-		graphics_objects->base_path + PATHS::LEVEL_DATA::LOCATION + PATHS::LEVEL_DATA::TERRAIN_GENERATION_DATA
-	)) {
+	, wait_for_generation(_wait_for_generation)
+	, headless(_headless)
+	, chunk_generator(ChunkGenerator::load_terrain_rules(graphics_objects->base_path, graphics_objects->executable_path), _seed) {
 	next_chunk_id = 0;
+
+	if (!headless) {
+		for (std::unique_ptr<Framework::Image>& image : chunk_images) {
+			image = Framework::create_image(&graphics_objects->graphics, Framework::vec2{ GAME::CHUNK_WIDTH, GAME::CHUNK_HEIGHT });
+		}
+	}
+
+	for (uint32_t i = 0; i < chunk_workers.thread_count(); i++) {
+		terrain_solvers.push_back(chunk_generator.create_terrain_solver());
+		generated_chunks.push_back(std::make_unique<ChunkQueue>());
+	}
 }
 
-void Level::update(float dt, const Framework::vec2& player_position, Framework::InputHandler* input) {
+void Level::update(float dt, const Framework::vec2& player_position, const Framework::vec2& player_velocity, Framework::InputHandler* input) {
+	PROFILE_ZONE("Level::update");
+
+	previous_scroll = scroll;
+	scroll = player_position.x - GAME::PLAYER::STARTING_POSITION.x;
+
 	// Check which chunks need to be loaded
-	float left_edge = player_position.x - GAME::PLAYER::STARTING_POSITION.x;
-	float right_edge = left_edge + WINDOW::SIZE.x / SPRITES::SCALE;
+	// Rendering can be anywhere between the last two scroll positions, so chunks on screen at either are kept
+	float left_edge = std::max(std::min(previous_scroll, scroll), 0.0f);
+	float right_edge = std::max(previous_scroll, scroll) + WINDOW::SIZE.x / SPRITES::SCALE;
 	uint32_t leftmost_chunk_id = static_cast<uint32_t>(left_edge / GAME::CHUNK_WIDTH);
 	uint32_t rightmost_chunk_id = static_cast<uint32_t>(right_edge / GAME::CHUNK_WIDTH) + 1;
 
-	scroll = left_edge;
-
 	//printf("left: %f, right: %f\n", left_edge, right_edge);
 	//printf("l: %d, r: %u\n", leftmost_chunk_id, rightmost_chunk_id);
 
@@ -32,53 +43,100 @@ void Level::update(float dt, const Framework::vec2& player_position, Framework::
 		//generate_next_tile();
 	}
 
-	//while (next_chunk_id <= rightmost_chunk_id) {
-	if (next_chunk_id <= rightmost_chunk_id && chunk_loader_status == std::future_status::ready) {
-		std::cout << "New chunk___________" << std::endl;
-		//generate_next_chunk();
-		chunk_loader_thread = std::async(std::launch::async, [this]() { generate_next_chunk(); });
+	// Free up any chunks which are below the leftmost_chunk_id, to make room for new chunks
+	chunks.erase_before(leftmost_chunk_id);
+
+	// Plan chunks ahead of the screen, so that the workers have time to generate them before they're needed
+	// Stop if there isn't space to store the chunks
+	uint32_t lookahead_chunks = get_lookahead_chunks(player_velocity);
+	while (next_chunk_id <= rightmost_chunk_id + lookahead_chunks && next_chunk_id < leftmost_chunk_id + chunks.capacity()) {
+		if (planned_chunks.size() >= GAME::MAX_LOADED_CHUNKS) {
+			if (!wait_for_generation) break;
+
+			// Otherwise how far ahead the rail is planned would depend on how quickly the workers are generating chunks
+			wait_for_published_chunk();
+			collect_generated_chunks(leftmost_chunk_id);
+			continue;
+		}
+
+		queue_next_chunk();
 	}
-	
-	chunk_loader_status = chunk_loader_thread.wait_for(std::chrono::milliseconds(1));
 
-	// Also free up any chunks which are below the leftmost_chunk_id
-	// item == [key, value]
-	std::erase_if(chunks, [leftmost_chunk_id](const auto& item) { return item.first < leftmost_chunk_id; });
-}
+	collect_generated_chunks(leftmost_chunk_id);
 
-void Level::render() {
-	for (const auto& [chunk_id, chunk] : chunks) {
-		Framework::vec2 chunk_pos = Framework::Vec(chunk_id * GAME::CHUNK_TILE_WIDTH, 0);
-		graphics_objects->graphics.render_rect({ chunk_pos * SPRITES::SCALE * SPRITES::SIZE - Framework::vec2{scroll * SPRITES::SCALE, 0}, {GAME::CHUNK_WIDTH * SPRITES::SCALE, GAME::CHUNK_HEIGHT * SPRITES::SCALE}}, COLOURS::WHITE);
-		Framework::vec2 tile_pos = chunk_pos;
-		for (const ChunkColumn& column : chunk.chunk_grid) {
-			tile_pos.y = 0;
-			for (uint32_t tile_id : column) {
-				if (tile_id != SPRITES::INDEX::NONE) {
-					Framework::vec2 pos = tile_pos * SPRITES::SIZE;
-					pos.x -= scroll;
-					graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(tile_id, pos);
-				}
-				tile_pos.y++;
+	if (wait_for_generation) {
+		// Wait for every chunk on screen, as if they had to be drawn, so that the time taken to generate them is counted
+		for (uint32_t chunk_id = leftmost_chunk_id; chunk_id <= rightmost_chunk_id && chunk_id < next_chunk_id; chunk_id++) {
+			while (!chunks.contains(chunk_id)) {
+				wait_for_published_chunk();
+				collect_generated_chunks(leftmost_chunk_id);
 			}
-			tile_pos.x++;
 		}
 	}
 }
 
+void Level::render(float alpha) {
+	PROFILE_ZONE("Level::render");
+
+	float render_scroll = std::lerp(previous_scroll, scroll, alpha);
+
+	// Find the range of tile columns which are on screen (last_column is one past the end)
+	float left_edge = std::max(render_scroll, 0.0f);
+	float right_edge = left_edge + WINDOW::SIZE.x / SPRITES::SCALE;
+	uint32_t first_column = static_cast<uint32_t>(left_edge / SPRITES::SIZE);
+	uint32_t last_column = static_cast<uint32_t>(std::ceil(right_edge / SPRITES::SIZE));
+
+	// Only look at the chunks in that range, however many are loaded
+	for (uint32_t chunk_id = first_column / GAME::CHUNK_TILE_WIDTH; chunk_id <= (last_column - 1) / GAME::CHUNK_TILE_WIDTH; chunk_id++) {
+		if (!chunks.contains(chunk_id)) continue; // Chunk not generated yet
+
+		// Only draw the part of the chunk which is on screen
+		uint32_t chunk_column = chunk_id * GAME::CHUNK_TILE_WIDTH;
+		uint32_t start_column = std::max(first_column, chunk_column) - chunk_column;
+		uint32_t end_column = std::min(last_column, chunk_column + GAME::CHUNK_TILE_WIDTH) - chunk_column;
+
+		Framework::Rect source_rect(start_column * SPRITES::SIZE, 0, (end_column - start_column) * SPRITES::SIZE, GAME::CHUNK_HEIGHT);
+		Framework::Rect destination_rect = source_rect;
+		destination_rect.position.x += chunk_column * SPRITES::SIZE - render_scroll;
+		chunk_images[chunks.slot_index(chunk_id)]->render(source_rect, destination_rect * SPRITES::SCALE);
+
+		if (DEBUG::SHOW_CHUNK_OUTLINES) {
+			Framework::Rect chunk_rect(Framework::vec2{ chunk_column * SPRITES::SIZE - render_scroll, 0 }, Framework::vec2{ GAME::CHUNK_WIDTH, GAME::CHUNK_HEIGHT });
+			graphics_objects->graphics.render_rect(chunk_rect * SPRITES::SCALE, COLOURS::WHITE);
+		}
+	}
+}
+
+uint32_t Level::get_loaded_chunk_count() const {
+	return chunks.size();
+}
+
+uint32_t Level::get_planned_chunk_count() const {
+	return static_cast<uint32_t>(planned_chunks.size());
+}
+
+uint32_t Level::get_last_chunk_id() const {
+	return last_chunk_id;
+}
+
+const ChunkGenerator::ChunkStatistics& Level::get_last_chunk_statistics() const {
+	return last_chunk_statistics;
+}
+
 uint32_t Level::get_seed() {
 	return seed;
 }
 
 bool Level::touching_rail(Framework::Rect rect) {
-	std::vector<uint32_t> rail_tile_ids = wfc.get_option_collections().rail;
+	const std::vector<uint32_t>& rail_tile_ids = chunk_generator.get_terrain_rules().options.rail;
 
 	for (auto [chunk_id, x, y] : get_overlapping_tile_coords(rect)) {
 		// Check if each tile is a rail
-		if (!chunks.contains(chunk_id)) continue; // Chunk not generated?
+		const Chunk* chunk = chunks.find(chunk_id);
+		if (!chunk) continue; // Chunk not generated?
 
 		// TODO: check x and y - are these not necessarily valid? (y must be valid)
-		uint32_t tile_id = chunks.at(chunk_id).chunk_grid[x][y];
+		uint32_t tile_id = chunk->chunk_grid[x][y];
 
 		if (std::find(rail_tile_ids.begin(), rail_tile_ids.end(), tile_id) != rail_tile_ids.end()) {
 			// tile_id was a rail tile
@@ -114,10 +172,11 @@ float Level::rail_height_at(float x) {
 	uint32_t tile_x = x / SPRITES::SIZE;
 
 	// Often because chunk is not loaded
-	if (!chunks.contains(chunk_id)) return GAME::CHUNK_HEIGHT + SPRITES::SIZE; // Enough to disappear off screen
+	RailHeights rail_heights = get_rail_heights(chunk_id);
+	if (rail_heights.empty()) return GAME::CHUNK_HEIGHT + SPRITES::SIZE; // Enough to disappear off screen
 
 	// Offset tile_x by 1 because rail_heights is 2 wider than the chunk, one at each end
-	auto [height, direction] = get_rail_heights(chunk_id).at(tile_x + 1);
+	auto [height, direction] = rail_heights.at(tile_x + 1);
 	height *= SPRITES::SIZE;
 
 	float scale = (x - tile_x * SPRITES::SIZE) / SPRITES::SIZE;
@@ -134,7 +193,12 @@ float Level::rail_height_at(float x) {
 }
 
 std::vector<std::pair<uint8_t, Level::RailDirection>> Level::get_rail_heights(uint32_t chunk_id) {
-	return chunks.at(chunk_id).rail_heights;
+	if (const Chunk* chunk = chunks.find(chunk_id)) return chunk->rail_heights;
+
+	// Rail path is known before the rest of the chunk has been generated
+	if (planned_chunks.contains(chunk_id)) return planned_chunks.at(chunk_id).rail_heights;
+
+	return {};
 }
 
 std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> Level::get_overlapping_tile_coords(Framework::Rect rect) {
@@ -171,146 +235,86 @@ std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> Level::get_overlapping_til
 	return coord_list;
 }
 
-void Level::generate_next_chunk() {
-	Chunk last_chunk;
-	if (next_chunk_id == 0) {
-		for (uint8_t i = 0; i < 2; i++) {
-			last_chunk.rail_heights.emplace_back(GAME::CHUNK_TILE_HEIGHT / 2, RailDirection::NONE); // TODO: maybe pick more intelligently
-		}
-	}
-	else {
-		last_chunk = chunks.at(next_chunk_id - 1);
-	}
+uint32_t Level::get_lookahead_chunks(const Framework::vec2& player_velocity) {
+	uint32_t lookahead_chunks = std::max(GAME::MIN_LOOKAHEAD_CHUNKS, chunk_workers.thread_count());
 
-	Chunk chunk;
+	// Cover the distance the player will travel while the chunks are being generated
+	// Only moving right matters, since chunks on the left are never generated again
+	float lookahead_distance = std::max(player_velocity.x, 0.0f) * GAME::LOOKAHEAD_TIME;
+	lookahead_chunks += static_cast<uint32_t>(std::ceil(lookahead_distance / GAME::CHUNK_WIDTH));
 
-	std::cout << "Chunk " << next_chunk_id << " seed: " << random.get_state() << std::endl;
+	return lookahead_chunks;
+}
 
-	// Reset grid stored within the wavefront solver
-	wfc.reset();
+void Level::queue_next_chunk() {
+	ChunkPlan plan = chunk_generator.plan_next_chunk();
+	planned_chunks.emplace(plan.chunk_id, plan);
+	next_chunk_id++;
 
-	// NOTE: alternative idea: generate terrain, then fit rail to it on a second pass?
+	chunk_workers.submit<void>([this, plan](uint32_t thread_index) {
+		publish_chunk(chunk_generator.generate_chunk(plan, *terrain_solvers[thread_index]), thread_index);
+	});
+}
 
-	WaveFunctionCollapse::OptionCollections options = wfc.get_option_collections();
-	std::vector<uint32_t> non_rail = wfc.get_option_collections().all;
-	std::erase_if(non_rail, [options](uint32_t o) { return std::find(options.rail.begin(), options.rail.end(), o) != options.rail.end(); });
-	for (uint8_t x = 0; x < GAME::CHUNK_TILE_WIDTH + 2; x++) {
-		// Don't allow rails on the very bottom line
-		wfc.set_cell(x, GAME::CHUNK_TILE_HEIGHT - 1, non_rail);
+void Level::publish_chunk(Chunk&& chunk, uint32_t thread_index) {
+	if (!generated_chunks[thread_index]->push(std::move(chunk))) {
+		// Can't happen, since the queue can hold every planned chunk
+		std::cerr << "Generated chunk queue is full!" << std::endl;
 	}
 
-	for (uint8_t i = 0; i < 2; i++) {
-		auto [height, direction] = last_chunk.rail_heights.at(i + last_chunk.rail_heights.size() - 2);
-		chunk.rail_heights.emplace_back(height, direction);
-
-		uint32_t index;
-		switch (direction) {
-		case RailDirection::NONE:
-			index = 133;
-			break;
-		case RailDirection::UP:
-			index = 187;
-			height++;
-			break;
-		case RailDirection::DOWN:
-			index = 188;
-			break;
-		}
-		//std::cout << "Copying " << index << " to (" << (int)i << ", " << (int)height << ")" << std::endl;
-		wfc.set_cell(i, height, index);
-	}
+	// Counted after the push, so that a waiting main thread always finds the chunk once it wakes up
+	published_chunk_count.fetch_add(1, std::memory_order_release);
+	published_chunk_count.notify_one();
+}
 
-	/*std::cout << "Last rail heights: ";
-	for (auto [a,t] : last_chunk_data.rail_heights) {
-		std::cout << (int)a << ", ";
-	}
-	std::cout << std::endl;
+void Level::bake_chunk(const Chunk& chunk) {
+	Framework::Image* image = chunk_images[chunks.slot_index(chunk.chunk_id)].get();
+	const Framework::Spritesheet& spritesheet = graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET];
 
-	std::cout << "New rail heights: ";
-	for (auto [a, t] : rail_heights) {
-		std::cout << (int)a << ", ";
-	}
-	std::cout << std::endl;*/
-
-	// TODO: in middle of changing to use last_chunk_data.rail_heights
-	for (uint8_t x = 2; x < GAME::CHUNK_TILE_WIDTH + 2; x++) {
-		// Generate a path for the rail
-		// Do this by selecting a direction to travel in each frame
-		auto [previous_rail_height, previous_rail_direction] = chunk.rail_heights.at(chunk.rail_heights.size() - 1);
-		uint32_t new_rail_height = previous_rail_height;
-		float value = random.random();
-
-		// TODO: make these constants?
-		if (value < 0.25f && previous_rail_direction != RailDirection::DOWN && previous_rail_height > 12) {
-			// Go up, but only if wasn't just going down
-			new_rail_height--;
-			previous_rail_direction = RailDirection::UP;
-
-			// TODO: set tile options
-			wfc.set_cell(x, new_rail_height + 1, 187); // TODO: change to list of options
-		}
-		else if (0.25f <= value && value < 0.5f && previous_rail_direction != RailDirection::UP && previous_rail_height < 20) {
-			// Go down, but only if wasn't just going up
-			new_rail_height++;
-			previous_rail_direction = RailDirection::DOWN;
+	// Image may still have the tiles of the last chunk in this slot
+	image->clear();
 
-			// TODO: set tile options
-			wfc.set_cell(x, new_rail_height, 188); // TODO: change to list of options
-		}
-		else {
-			// Go straight
-			// So do nothing
-			previous_rail_direction = RailDirection::NONE;
+	image->set_render_target();
 
-			// TODO: instead of forcing these sprites, instead add these as options to wave function
-			wfc.set_cell(x, new_rail_height, 133); // TODO: change to list of options
+	// Rendered unscaled, and scaled up when the image is drawn
+	Framework::vec2 tile_pos = Framework::VEC_NULL;
+	for (const ChunkColumn& column : chunk.chunk_grid) {
+		tile_pos.y = 0;
+		for (uint32_t tile_id : column) {
+			if (tile_id != SPRITES::INDEX::NONE) {
+				spritesheet.sprite(tile_id, tile_pos * SPRITES::SIZE, 1.0f);
+			}
+			tile_pos.y++;
 		}
-		chunk.rail_heights.emplace_back(new_rail_height, previous_rail_direction);
+		tile_pos.x++;
 	}
 
-	// Copy last column of tiles from the previous chunk
-	if (next_chunk_id > 0) {
-		for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
-			if (last_chunk.chunk_grid[GAME::CHUNK_TILE_WIDTH - 1][y] < 256) // TEMP
-			wfc.set_cell(0, y, last_chunk.chunk_grid[GAME::CHUNK_TILE_WIDTH - 1][y]);
-			//std::cout << "y=" << (int)y << ": " << last_chunk[GAME::CHUNK_TILE_WIDTH - 1][y] << std::endl;
+	image->unset_render_target();
+}
 
-			/*std::cout << "y=" << (int)y << ": ";
-			for (auto option : wfc.get_cell_options(1, y)) {
-				std::cout << option << ", ";
-			}
-			std::cout << std::endl;*/
-		}
-	}
+void Level::collect_generated_chunks(uint32_t leftmost_chunk_id) {
+	for (std::unique_ptr<ChunkQueue>& queue : generated_chunks) {
+		while (std::optional<Chunk> chunk = queue->pop()) {
+			uint32_t chunk_id = chunk->chunk_id;
 
-	// TODO: don't actually do this - need to incorporate generated terrain
-	if (!wfc.collapse(random)) {
-		// Rather hacky approach: just try again!
-		// This could get stuck in an infinite loop if it is impossible to find a valid chunk
-		//generate_next_chunk();
-		//return;
-	}
+			last_chunk_id = chunk_id;
+			last_chunk_statistics = chunk->statistics;
 
-	// Copy data from wfc to chunk
-	// Don't copy leftmost column, since that's used to stitch together the chunks
-	for (uint8_t x = 0; x < GAME::CHUNK_TILE_WIDTH; x++) {
-		for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
-			if (auto value = wfc.get_cell(x + 1, y)) {
-				chunk.chunk_grid[x][y] = value.value();
+			// Chunk may have already gone off the left of the screen, in which case its slot could belong to a newer chunk
+			if (chunk_id >= leftmost_chunk_id) {
+				if (!headless) bake_chunk(chunk.value());
+				chunks.insert(chunk_id, std::move(chunk.value()));
 			}
+			planned_chunks.erase(chunk_id);
+			collected_chunk_count++;
 		}
 	}
+}
 
-	// TEMP: put coins in incomplete cells
-	for (uint8_t x = 0; x < GAME::CHUNK_TILE_WIDTH; x++) {
-		for (uint8_t y = 0; y < GAME::CHUNK_TILE_HEIGHT; y++) {
-			chunk.chunk_grid[x][y] = 144;
-			if (auto value = wfc.get_cell(x + 1, y)) {
-				chunk.chunk_grid[x][y] = value.value();
-			}
-		}
+void Level::wait_for_published_chunk() {
+	// A chunk can be collected just before it's counted, so the count can briefly be behind
+	uint32_t published = published_chunk_count.load(std::memory_order_acquire);
+	if (published == collected_chunk_count) {
+		published_chunk_count.wait(published, std::memory_order_acquire);
 	}
-
-	chunks.emplace(next_chunk_id, chunk);
-	next_chunk_id++;
 }
@@ -33,7 +33,7 @@ bool IntroStage::update(float dt) {
 	return true;
 }
 
-void IntroStage::render() {
+void IntroStage::render(float) {
 	graphics_objects->graphics.fill(COLOURS::BLACK);
 
 	// Display the Scorpion Games logo
@@ -108,7 +108,7 @@ bool TitleStage::update(float dt) {
 	return true;
 }
 
-void TitleStage::render() {
+void TitleStage::render(float) {
 	graphics_objects->graphics.fill(COLOURS::BLUE);
 
 	// Display title text in the centre of the display
@@ -11,9 +11,15 @@ Player::Player(Framework::GraphicsObjects* _graphics_objects)
 	angle = 0.0f;
 	wheels.left_y = wheels.right_y = position.y;
 	start_delay.start();
+
+	previous_state = get_current_state();
 }
 
 void Player::update(float dt, Framework::InputHandler* input, Level& level) {
+	PROFILE_ZONE("Player::update");
+
+	previous_state = get_current_state();
+
 	start_delay.update(dt);
 	if (start_delay.time() < 1.0f) return;
 
@@ -53,13 +59,6 @@ void Player::update(float dt, Framework::InputHandler* input, Level& level) {
 	wheels.right_y = level.rail_height_at(position.x + 5 + 3) - 4 - 1;
 	//position.y = (wheels.left_y + wheels.right_y) / 2.0f - 1.0f;
 
-	//if (level.touching_rail(Framework::Rect(position, { 10, 5 }))) {
-		//on_rail = true;
-		//position.y = 
-	//}
-}
-
-void Player::render() {
 	// Rotate minecart if on slope
 	// Note: this could avoid visual flickering if the rail_height_at function returned the direction of the rail
 	// TODO: clipping with rails occurs due to only using midpoint of minecart. Is there a better way?
@@ -67,17 +66,28 @@ void Player::render() {
 	// TODO: idea: check rail height at both wheels. Set minecart height to avg of that, then rotate minecart as necessary to line up wheels?
 	// Note that due to rotations the visual wheel locations will be slightly different, but shouldn't be too noticable
 
+	// Done here rather than in render, so that the angle only changes once per update however many frames are drawn
 	if (on_rail) {
 		angle = atan2(wheels.right_y - wheels.left_y, 6) * 180.0f * std::numbers::inv_pi;
 	}
 	// Otherwise, keep previous angle
 
-	graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].rect(SPRITES::RECT::MINECART, { GAME::PLAYER::STARTING_POSITION.x - 3, position.y - 4 }, SPRITES::SCALE, angle, { 8 * SPRITES::SCALE, 8 * SPRITES::SCALE });
+	//if (level.touching_rail(Framework::Rect(position, { 10, 5 }))) {
+		//on_rail = true;
+		//position.y = 
+	//}
+}
+
+void Player::render(float alpha) {
+	// Draw between the last two updates, so that the minecart moves smoothly however often it's updated
+	State state = get_interpolated_state(alpha);
+
+	graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].rect(SPRITES::RECT::MINECART, { GAME::PLAYER::STARTING_POSITION.x - 3, state.position.y - 4 }, SPRITES::SCALE, state.angle, { 8 * SPRITES::SCALE, 8 * SPRITES::SCALE });
 
 	// Render wheels
 	//graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(SPRITES::INDEX::WHEEL, { GAME::PLAYER::STARTING_POSITION.x - 3 + 4, position.y - 3 + 3 }, SPRITES::SCALE, angle, { 4 * SPRITES::SCALE, 4 * SPRITES::SCALE });
-	graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(SPRITES::INDEX::WHEEL, { GAME::PLAYER::STARTING_POSITION.x - 3 + 1, position.y - 3 + 3 }, SPRITES::SCALE, angle, { 7 * SPRITES::SCALE, 4 * SPRITES::SCALE });
-	graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(SPRITES::INDEX::WHEEL, { GAME::PLAYER::STARTING_POSITION.x - 3 + 7, position.y - 3 + 3 }, SPRITES::SCALE, angle, { 1 * SPRITES::SCALE, 4 * SPRITES::SCALE });
+	graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(SPRITES::INDEX::WHEEL, { GAME::PLAYER::STARTING_POSITION.x - 3 + 1, state.position.y - 3 + 3 }, SPRITES::SCALE, state.angle, { 7 * SPRITES::SCALE, 4 * SPRITES::SCALE });
+	graphics_objects->spritesheets[GRAPHICS_OBJECTS::SPRITESHEETS::MAIN_SPRITESHEET].sprite(SPRITES::INDEX::WHEEL, { GAME::PLAYER::STARTING_POSITION.x - 3 + 7, state.position.y - 3 + 3 }, SPRITES::SCALE, state.angle, { 1 * SPRITES::SCALE, 4 * SPRITES::SCALE });
 
 	return;
 
@@ -133,3 +143,22 @@ Framework::vec2 Player::get_position() const {
 	return position;
 }
 
+Framework::vec2 Player::get_velocity() const {
+	return velocity;
+}
+
+Player::State Player::get_previous_state() const {
+	return previous_state;
+}
+
+Player::State Player::get_current_state() const {
+	return State{ position, angle };
+}
+
+Player::State Player::get_interpolated_state(float alpha) const {
+	return State{
+		Framework::vec2{ std::lerp(previous_state.position.x, position.x, alpha), std::lerp(previous_state.position.y, position.y, alpha) },
+		std::lerp(previous_state.angle, angle, alpha)
+	};
+}
+
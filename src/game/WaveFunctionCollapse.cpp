@@ -0,0 +1,685 @@
+#include "WaveFunctionCollapse.hpp"
+
+#ifdef COMPILED_TERRAIN_RULES
+// Generated at build time by the rule compiler
+#include "CompiledTerrainRules.hpp"
+#endif
+
+template <typename Rules>
+BasicWaveFunctionCollapse<Rules>::BasicWaveFunctionCollapse(uint8_t _width, uint8_t _height, Rules _rules)
+	: rules(std::move(_rules))
+	, option_sampler(rules.relative_frequencies)
+	, width(_width), height(_height) {
+	for (uint32_t index = 0; index < rules.option_values.size(); index++) {
+		all_options.set(index);
+
+		for (uint8_t i = 0; i < DIRECTION_COUNT; i++) {
+			all_options_supported[i] |= rules.valid_options_lookup[index][i];
+		}
+	}
+
+	cells.resize(width * height, Cell{ false, all_options });
+	cell_stamps.resize(width * height, 0);
+	cell_versions.resize(width * height, 0);
+	cell_noise.resize(width * height, 0.0f);
+	propagation_queued.resize(width * height, false);
+	update_options();
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::reset() {
+	std::fill(cells.begin(), cells.end(), Cell{ false, all_options });
+	while (history.size()) history.pop();
+	trail.clear();
+
+	entropy_queue = {};
+	entropy_queue_built = false;
+	empty_cells = 0;
+
+	statistics = {};
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::set_cell(uint8_t x, uint8_t y, uint32_t value) {
+	uint32_t index = y * width + x;
+	update_cell(index, true, to_option_set({ value }));
+	queue_propagation(index);
+	propagate();
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::set_cell(uint8_t x, uint8_t y, std::vector<uint32_t> values) {
+	uint32_t index = y * width + x;
+	update_cell(index, cells.at(index).collapsed, to_option_set(values));
+	queue_propagation(index);
+	propagate();
+}
+
+template <typename Rules>
+std::optional<uint32_t> BasicWaveFunctionCollapse<Rules>::get_cell(uint8_t x, uint8_t y) {
+	if (x < 0 || x >= width || y < 0 || y >= height) return {};
+	const Cell& cell = cells.at(y * width + x);
+	if (cell.options.count() != 1) return {};
+	return rules.option_values[cell.options.first()];
+}
+
+template <typename Rules>
+std::vector<uint32_t> BasicWaveFunctionCollapse<Rules>::get_cell_options(uint8_t x, uint8_t y) {
+	if (x < 0 || x >= width || y < 0 || y >= height) return {};
+
+	std::vector<uint32_t> values;
+	const OptionSet& cell_options = cells.at(y * width + x).options;
+	for (uint32_t index = cell_options.first(); index != OptionSet::NONE; index = cell_options.next(index)) {
+		values.push_back(rules.option_values[index]);
+	}
+	return values;
+}
+
+template <typename Rules>
+bool BasicWaveFunctionCollapse<Rules>::is_cell_collapsed(uint8_t x, uint8_t y) {
+	if (x < 0 || x >= width || y < 0 || y >= height) return false; // Not sure if should be true or false
+	return cells.at(y * width + x).collapsed;
+}
+
+template <typename Rules>
+bool BasicWaveFunctionCollapse<Rules>::is_option(uint32_t value) {
+	return value < rules.option_indices.size() && rules.option_indices[value] != NO_OPTION;
+}
+
+template <typename Rules>
+bool BasicWaveFunctionCollapse<Rules>::collapse_single_cell(RandomGenerator& random) {
+	if (empty_cells) {
+		// A cell has run out of options, so the last decision has to be undone
+		// If no decisions have been made, the constraints contradict each other and there's nothing to undo (collapse then gives up)
+		if (history.size() == 0) return false;
+		backtrack();
+
+		// We don't want to carry on to the rest of the function:
+		// everything needs to be checked again
+		return false;
+	}
+
+	if (!entropy_queue_built) {
+		for (float& noise : cell_noise) {
+			noise = random.random() * GAME::ENTROPY_NOISE;
+		}
+		build_entropy_queue();
+	}
+
+	// Find cell with lowest entropy, skipping any entries which are out of date
+	while (entropy_queue.size() && entropy_queue.top().version != cell_versions[entropy_queue.top().index]) {
+		entropy_queue.pop();
+	}
+
+	if (entropy_queue.size() == 0) {
+		// No more options, we're done
+		if (DEBUG::LOG_GENERATION) std::cout << "Clean finish" << std::endl;
+		return true;
+	}
+	else {
+		uint32_t cell_index = entropy_queue.top().index;
+		entropy_queue.pop();
+
+		uint8_t x = cell_index % width;
+		uint8_t y = cell_index / width;
+
+		// Randomly select from the cell's options
+		uint32_t final_index = choose_option(cells[cell_index].options, random);
+
+		// Update history
+		history.emplace(trail.size(), x, y, final_index);
+		statistics.decisions++;
+
+		// Any changes from now on belong to the new decision
+		current_stamp++;
+
+		// Set that cell to the collapsed value
+		OptionSet final_options;
+		final_options.set(final_index);
+		update_cell(cell_index, true, final_options);
+
+		// Update the rest of the grid
+		queue_propagation(cell_index);
+		propagate();
+
+		// Assume that there is still more to do
+		return false;
+	}
+}
+
+template <typename Rules>
+bool BasicWaveFunctionCollapse<Rules>::collapse(RandomGenerator& random, uint32_t max_restarts) {
+	uint32_t restart_attempts = 0;
+	uint32_t collapse_attempts = 0;
+	while (!collapse_single_cell(random)) {
+		// The starting constraints contradict each other, so restarting would end up here again
+		if (empty_cells && history.size() == 0) return false;
+
+		collapse_attempts++;
+		if (collapse_attempts >= GAME::MAX_COLLAPSE_ATTEMPTS) {
+			// Restart from beginning
+			restart();
+			collapse_attempts = 0;
+			restart_attempts++;
+			if (restart_attempts > max_restarts) {
+				if (DEBUG::LOG_GENERATION) std::cerr << "Max restart attempts exceeded!" << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template <typename Rules>
+typename BasicWaveFunctionCollapse<Rules>::OptionCollections BasicWaveFunctionCollapse<Rules>::get_option_collections() {
+	return rules.options;
+}
+
+template <typename Rules>
+typename BasicWaveFunctionCollapse<Rules>::Statistics BasicWaveFunctionCollapse<Rules>::get_statistics() {
+	return statistics;
+}
+
+template <typename Rules>
+typename BasicWaveFunctionCollapse<Rules>::Statistics& BasicWaveFunctionCollapse<Rules>::Statistics::operator+=(const Statistics& other) {
+	decisions += other.decisions;
+	backtracks += other.backtracks;
+	restarts += other.restarts;
+	return *this;
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::update_options() {
+	// Adjust all options based on every cell's current options
+	for (uint32_t index = 0; index < cells.size(); index++) {
+		queue_propagation(index);
+	}
+	propagate();
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::propagate() {
+	while (propagation_queue.size()) {
+		uint32_t index = propagation_queue.back();
+		propagation_queue.pop_back();
+		propagation_queued[index] = false;
+
+		// The grid needs backtracking anyway, so there's no point carrying on
+		if (empty_cells) {
+			for (uint32_t queued_index : propagation_queue) {
+				propagation_queued[queued_index] = false;
+			}
+			propagation_queue.clear();
+			return;
+		}
+
+		// Find everything the cell allows in each direction
+		const OptionSet& cell_options = cells[index].options;
+		std::array<OptionSet, DIRECTION_COUNT> supported_options{};
+		if (cell_options == all_options) {
+			supported_options = all_options_supported;
+		}
+		else {
+			for (uint32_t option = cell_options.first(); option != OptionSet::NONE; option = cell_options.next(option)) {
+				for (uint8_t i = 0; i < DIRECTION_COUNT; i++) {
+					supported_options[i] |= rules.valid_options_lookup[option][i];
+				}
+			}
+		}
+
+		uint8_t x = index % width;
+		uint8_t y = index / width;
+		for (uint8_t i = 0; i < DIRECTION_COUNT; i++) {
+			auto [dx, dy] = directions[i];
+			reduce_options(x + dx, y + dy, supported_options[i]);
+		}
+	}
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::queue_propagation(uint32_t index) {
+	if (propagation_queued[index]) return;
+
+	propagation_queued[index] = true;
+	propagation_queue.push_back(index);
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::reduce_options(uint8_t x, uint8_t y, const OptionSet& valid_options) {
+	if (x < 0 || x >= width || y < 0 || y >= height) return;
+	uint32_t index = y * width + x;
+
+	OptionSet reduced_options = cells[index].options;
+	reduced_options &= valid_options;
+
+	// Nothing to save or propagate if no options were removed
+	if (reduced_options == cells[index].options) return;
+
+	update_cell(index, cells[index].collapsed, reduced_options);
+	queue_propagation(index);
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::backtrack() {
+	// Undo last decision and remove the option from the available choices
+
+	if (history.size() == 0) {
+		// No way of restarting!
+		if (DEBUG::LOG_GENERATION) std::cerr << "Error while generating level: cannot backtrack any further!" << std::endl;
+		return;
+	}
+
+	// Get last decision made
+	Decision last_decision = history.top();
+	history.pop(); // Remove last decision from history
+	statistics.backtracks++;
+
+	// Undo state
+	undo_trail(last_decision.trail_size);
+
+	// Changes from now on belong to the previous decision, but cells already saved for that decision may need saving again
+	current_stamp++;
+
+	// Update available choices
+	uint32_t index = last_decision.y * width + last_decision.x;
+	OptionSet remaining_options = cells[index].options;
+	remaining_options.reset(last_decision.chosen_index);
+	update_cell(index, cells[index].collapsed, remaining_options);
+
+	// Update surrounding cells
+	queue_propagation(index);
+	propagate();
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::restart() {
+	if (DEBUG::LOG_GENERATION && history.size()) {
+		std::cout << "Restarting!" << std::endl;
+	}
+
+	while (history.size()) history.pop();
+	statistics.restarts++;
+
+	// Get original state
+	undo_trail(0);
+	current_stamp++;
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::record_cell(uint32_t index) {
+	// Changes made before the first decision are never undone, so don't need saving
+	if (history.size() == 0) return;
+
+	if (cell_stamps[index] != current_stamp) {
+		cell_stamps[index] = current_stamp;
+		trail.emplace_back(index, cells[index]);
+	}
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::undo_trail(size_t trail_size) {
+	// Restore in reverse order, so the oldest saved state of each cell is the one left in place
+	while (trail.size() > trail_size) {
+		const TrailEntry& entry = trail.back();
+
+		if (cells[entry.index].options.empty()) empty_cells--;
+		if (entry.previous.options.empty()) empty_cells++;
+
+		cells[entry.index] = entry.previous;
+		queue_cell(entry.index);
+		trail.pop_back();
+	}
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::update_cell(uint32_t index, bool collapsed, const OptionSet& cell_options) {
+	record_cell(index);
+
+	Cell& cell = cells[index];
+	if (cell.options.empty()) empty_cells--;
+	if (cell_options.empty()) empty_cells++;
+
+	cell.collapsed = collapsed;
+	cell.options = cell_options;
+	queue_cell(index);
+}
+
+template <typename Rules>
+float BasicWaveFunctionCollapse<Rules>::calculate_entropy(const OptionSet& cell_options) {
+	// H = log(sum(w)) - sum(w * log(w)) / sum(w)
+	float weight_sum = 0.0f;
+	float weight_log_weight_sum = 0.0f;
+	for (uint32_t index = cell_options.first(); index != OptionSet::NONE; index = cell_options.next(index)) {
+		weight_sum += rules.relative_frequencies[index];
+		weight_log_weight_sum += rules.weight_log_weights[index];
+	}
+
+	// Only options which should never be picked are left
+	if (weight_sum <= 0.0f) return 0.0f;
+
+	return std::log(weight_sum) - weight_log_weight_sum / weight_sum;
+}
+
+template <typename Rules>
+uint32_t BasicWaveFunctionCollapse<Rules>::choose_option(const OptionSet& cell_options, RandomGenerator& random) {
+	// Sample from every option, and try again if the sample isn't one of the cell's options
+	// Each accepted sample has exactly the right distribution, so this only fails for cells with a small share of the total weight
+	if (option_sampler.size()) {
+		for (uint32_t attempt = 0; attempt < GAME::MAX_OPTION_SAMPLE_ATTEMPTS; attempt++) {
+			uint32_t index = random.sample(option_sampler);
+			if (cell_options.test(index)) return index;
+		}
+	}
+
+	uint32_t weight_sum = 0;
+	for (uint32_t index = cell_options.first(); index != OptionSet::NONE; index = cell_options.next(index)) {
+		weight_sum += rules.relative_frequencies[index];
+	}
+
+	// Only options which should never be picked are left, so treat them all equally
+	if (weight_sum == 0) {
+		uint32_t count = cell_options.count();
+		uint32_t remaining = std::min(static_cast<uint32_t>(random.random() * count), count - 1);
+
+		uint32_t index = cell_options.first();
+		while (remaining--) index = cell_options.next(index);
+		return index;
+	}
+
+	// Walk through the options until the chosen amount of weight has been passed
+	uint32_t remaining = std::min(static_cast<uint32_t>(random.random() * weight_sum), weight_sum - 1);
+	uint32_t index = cell_options.first();
+	while (remaining >= rules.relative_frequencies[index]) {
+		remaining -= rules.relative_frequencies[index];
+		index = cell_options.next(index);
+	}
+	return index;
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::queue_cell(uint32_t index) {
+	cell_versions[index]++;
+
+	// Queue is built from scratch before it's first used
+	if (!entropy_queue_built) return;
+
+	const Cell& cell = cells[index];
+	if (cell.collapsed || cell.options.empty()) return;
+
+	// Lots of backtracking can leave the queue mostly full of old entries
+	if (entropy_queue.size() > GAME::MAX_ENTROPY_QUEUE_FACTOR * cells.size()) {
+		build_entropy_queue();
+		return;
+	}
+
+	entropy_queue.emplace(calculate_entropy(cell.options) + cell_noise[index], index, cell_versions[index]);
+}
+
+template <typename Rules>
+void BasicWaveFunctionCollapse<Rules>::build_entropy_queue() {
+	entropy_queue = {};
+	entropy_queue_built = true;
+
+	for (uint32_t index = 0; index < cells.size(); index++) {
+		const Cell& cell = cells[index];
+		if (cell.collapsed || cell.options.empty()) continue;
+
+		entropy_queue.emplace(calculate_entropy(cell.options) + cell_noise[index], index, cell_versions[index]);
+	}
+}
+
+template <typename Rules>
+typename BasicWaveFunctionCollapse<Rules>::OptionSet BasicWaveFunctionCollapse<Rules>::to_option_set(const std::vector<uint32_t>& values) {
+	return to_option_set(rules.option_indices, values);
+}
+
+template <typename Rules>
+typename BasicWaveFunctionCollapse<Rules>::OptionSet BasicWaveFunctionCollapse<Rules>::to_option_set(std::span<const uint32_t> option_indices, const std::vector<uint32_t>& values) {
+	OptionSet option_set;
+	for (uint32_t value : values) {
+		if (value < option_indices.size() && option_indices[value] != NO_OPTION) option_set.set(option_indices[value]);
+	}
+	return option_set;
+}
+
+// Instantiate the solver for the runtime rules, and for the compiled rules if they're being used
+template class BasicWaveFunctionCollapse<WFC::RuleSet>;
+
+#ifdef COMPILED_TERRAIN_RULES
+template class BasicWaveFunctionCollapse<CompiledTerrainRules>;
+#endif
+
+WaveFunctionCollapse::WaveFunctionCollapse(uint8_t _width, uint8_t _height, OptionCollections _options, std::map<uint32_t, uint32_t> _relative_frequencies, std::map<uint32_t, ValidOptions> _valid_options_lookup)
+	: BasicWaveFunctionCollapse(_width, _height, create_rules(_options, _relative_frequencies, _valid_options_lookup)) {
+
+}
+
+WaveFunctionCollapse WaveFunctionCollapse::create_from_file(uint8_t _width, uint8_t _height, std::string filepath) {
+	return WaveFunctionCollapse(_width, _height, load_rules(filepath));
+}
+
+WaveFunctionCollapse::RuleSet WaveFunctionCollapse::create_rules(OptionCollections _options, std::map<uint32_t, uint32_t> _relative_frequencies, std::map<uint32_t, ValidOptions> _valid_options_lookup) {
+	std::shared_ptr<RuleStorage> storage = std::make_shared<RuleStorage>();
+
+	// Compile option values into dense indices
+	for (uint32_t value : _options.all) {
+		if (value > MAX_OPTION_VALUE) {
+			throw std::runtime_error("WaveFunctionCollapse option " + std::to_string(value) + " is too large (maximum is " + std::to_string(MAX_OPTION_VALUE) + ")!");
+		}
+
+		if (value >= storage->option_indices.size()) storage->option_indices.resize(value + 1, NO_OPTION);
+		if (storage->option_indices[value] != NO_OPTION) continue;
+
+		storage->option_indices[value] = static_cast<uint32_t>(storage->option_values.size());
+		storage->option_values.push_back(value);
+		storage->relative_frequencies.push_back(_relative_frequencies.contains(value) ? _relative_frequencies.at(value) : 0);
+
+		float weight = static_cast<float>(storage->relative_frequencies.back());
+		storage->weight_log_weights.push_back(weight > 0.0f ? weight * std::log(weight) : 0.0f);
+	}
+
+	if (storage->option_values.size() > GAME::MAX_TERRAIN_OPTIONS) {
+		throw std::runtime_error("Too many WaveFunctionCollapse options (" + std::to_string(storage->option_values.size()) + ", maximum is " + std::to_string(GAME::MAX_TERRAIN_OPTIONS) + ")!");
+	}
+
+	// Convert each option's adjacency lists into sets
+	// Options without an entry can't have anything next to them
+	storage->valid_options_lookup.resize(storage->option_values.size());
+	for (uint32_t index = 0; index < storage->option_values.size(); index++) {
+		auto it = _valid_options_lookup.find(storage->option_values[index]);
+		if (it == _valid_options_lookup.end()) continue;
+
+		const ValidOptions& valid_options = it->second;
+		storage->valid_options_lookup[index] = {
+			to_option_set(storage->option_indices, valid_options.up),
+			to_option_set(storage->option_indices, valid_options.down),
+			to_option_set(storage->option_indices, valid_options.left),
+			to_option_set(storage->option_indices, valid_options.right),
+		};
+	}
+
+	RuleSet _rules;
+	_rules.options = _options;
+	_rules.option_values = storage->option_values;
+	_rules.relative_frequencies = storage->relative_frequencies;
+	_rules.weight_log_weights = storage->weight_log_weights;
+	_rules.valid_options_lookup = storage->valid_options_lookup;
+	_rules.option_indices = storage->option_indices;
+	_rules.storage = storage;
+	return _rules;
+}
+
+WaveFunctionCollapse::RuleSet WaveFunctionCollapse::load_rules(std::string filepath) {
+	if (std::filesystem::path(filepath).extension() == PATHS::LEVEL_DATA::RULE_PACK_EXTENSION) {
+		return load_rule_pack(filepath);
+	}
+
+	Framework::JSONHandler::json data = Framework::JSONHandler::read(filepath);
+
+	try {
+		std::vector<uint32_t> _all_options;
+		std::map<uint32_t, uint32_t> _relative_frequencies;
+		for (auto& [key, value] : data.at(STRINGS::TERRAIN_GENERATION::ALL_OPTIONS).items()) {
+			_all_options.emplace_back(std::stoul(key));
+			_relative_frequencies.emplace(std::stoul(key), value);
+		}
+
+		std::map<uint32_t, WaveFunctionCollapse::ValidOptions> _valid_options_lookup;
+		for (auto& [key, value] : data.at(STRINGS::TERRAIN_GENERATION::VALID_OPTIONS).items()) {
+			WaveFunctionCollapse::ValidOptions valid_options;
+			valid_options.up = value.at(STRINGS::TERRAIN_GENERATION::UP).get<std::vector<uint32_t>>();
+			valid_options.down = value.at(STRINGS::TERRAIN_GENERATION::DOWN).get<std::vector<uint32_t>>();
+			valid_options.left = value.at(STRINGS::TERRAIN_GENERATION::LEFT).get<std::vector<uint32_t>>();
+			valid_options.right = value.at(STRINGS::TERRAIN_GENERATION::RIGHT).get<std::vector<uint32_t>>();
+
+			_valid_options_lookup.emplace(std::stoul(key), valid_options);
+		}
+
+		std::vector<uint32_t> _terrain_options = data.at(STRINGS::TERRAIN_GENERATION::TERRAIN_TILES).get<std::vector<uint32_t>>();
+		std::vector<uint32_t> _rail_options = data.at(STRINGS::TERRAIN_GENERATION::RAIL_TILES).get<std::vector<uint32_t>>();
+
+		WaveFunctionCollapse::OptionCollections options{ _all_options, _terrain_options, _rail_options };
+		return create_rules(options, _relative_frequencies, _valid_options_lookup);
+	}
+	catch (const Framework::JSONHandler::type_error& error) {
+		std::cerr << "Unable to parse JSON rule file for the WaveFunctionCollapse class!" << std::endl;
+		throw std::runtime_error("Unable to parse JSON rule file for the WaveFunctionCollapse class!");
+	}
+}
+
+WaveFunctionCollapse::RuleSet WaveFunctionCollapse::load_rule_pack(std::string filepath) {
+	std::shared_ptr<Framework::MappedFile> file = std::make_shared<Framework::MappedFile>();
+	if (!file->open(filepath)) {
+		throw std::runtime_error("Unable to open WaveFunctionCollapse rule pack " + filepath + "!");
+	}
+
+	const uint8_t* data = file->data();
+	size_t size = file->size();
+
+	if (size < sizeof(RulePackHeader)) {
+		throw std::runtime_error("WaveFunctionCollapse rule pack " + filepath + " is too small!");
+	}
+
+	const RulePackHeader* header = reinterpret_cast<const RulePackHeader*>(data);
+	if (header->byte_order != RULE_PACK_BYTE_ORDER) {
+		throw std::runtime_error("WaveFunctionCollapse rule pack " + filepath + " was built on a machine with a different byte order, and needs recompiling!");
+	}
+
+	if (header->magic != RULE_PACK_MAGIC || header->version != RULE_PACK_VERSION || header->word_count != OptionSet::WORD_COUNT) {
+		throw std::runtime_error("WaveFunctionCollapse rule pack " + filepath + " was built for a different version of the game, and needs recompiling!");
+	}
+
+	// Work out where each table starts
+	size_t offset = sizeof(RulePackHeader);
+	auto next_table = [&offset](size_t table_size) {
+		size_t table_offset = offset;
+		offset += table_size;
+		return table_offset;
+	};
+
+	size_t valid_options_lookup_offset = next_table(header->option_count * sizeof(std::array<OptionSet, DIRECTION_COUNT>));
+	size_t option_values_offset = next_table(header->option_count * sizeof(uint32_t));
+	size_t relative_frequencies_offset = next_table(header->option_count * sizeof(uint32_t));
+	size_t weight_log_weights_offset = next_table(header->option_count * sizeof(float));
+	size_t option_indices_offset = next_table(header->option_indices_size * sizeof(uint32_t));
+	size_t terrain_offset = next_table(header->terrain_count * sizeof(uint32_t));
+	size_t rail_offset = next_table(header->rail_count * sizeof(uint32_t));
+
+	if (offset != size || header->option_count > GAME::MAX_TERRAIN_OPTIONS || header->option_indices_size > MAX_OPTION_VALUE + 1) {
+		throw std::runtime_error("WaveFunctionCollapse rule pack " + filepath + " is corrupted!");
+	}
+
+	const uint32_t* option_values = reinterpret_cast<const uint32_t*>(data + option_values_offset);
+	const uint32_t* option_indices = reinterpret_cast<const uint32_t*>(data + option_indices_offset);
+	const std::array<OptionSet, DIRECTION_COUNT>* valid_options_lookup = reinterpret_cast<const std::array<OptionSet, DIRECTION_COUNT>*>(data + valid_options_lookup_offset);
+
+	// The solver indexes its tables with these without checking them, so a stale or damaged pack must not get any further
+	bool valid = true;
+
+	// Values and indices must map to each other
+	for (uint32_t index = 0; index < header->option_count; index++) {
+		uint32_t value = option_values[index];
+		valid &= value < header->option_indices_size && option_indices[value] == index;
+	}
+	for (uint32_t value = 0; value < header->option_indices_size; value++) {
+		uint32_t index = option_indices[value];
+		valid &= index == NO_OPTION || (index < header->option_count && option_values[index] == value);
+	}
+
+	// Adjacent options must be options
+	for (uint32_t index = 0; index < header->option_count; index++) {
+		for (const OptionSet& options : valid_options_lookup[index]) {
+			valid &= options.next(header->option_count) == OptionSet::NONE;
+		}
+	}
+
+	const uint32_t* terrain_options = reinterpret_cast<const uint32_t*>(data + terrain_offset);
+	const uint32_t* rail_options = reinterpret_cast<const uint32_t*>(data + rail_offset);
+
+	// Terrain tiles don't all need rules (any without them are left out by to_option_set), but the rail is placed tile by tile, so every rail tile must be an option
+	for (uint32_t i = 0; i < header->terrain_count; i++) {
+		valid &= terrain_options[i] <= MAX_OPTION_VALUE;
+	}
+	for (uint32_t i = 0; i < header->rail_count; i++) {
+		valid &= rail_options[i] < header->option_indices_size && option_indices[rail_options[i]] != NO_OPTION;
+	}
+
+	if (!valid) {
+		throw std::runtime_error("WaveFunctionCollapse rule pack " + filepath + " is corrupted!");
+	}
+
+	RuleSet _rules;
+	_rules.option_values = { option_values, header->option_count };
+	_rules.relative_frequencies = { reinterpret_cast<const uint32_t*>(data + relative_frequencies_offset), header->option_count };
+	_rules.weight_log_weights = { reinterpret_cast<const float*>(data + weight_log_weights_offset), header->option_count };
+	_rules.valid_options_lookup = { valid_options_lookup, header->option_count };
+	_rules.option_indices = { option_indices, header->option_indices_size };
+
+	_rules.options = {
+		std::vector<uint32_t>(_rules.option_values.begin(), _rules.option_values.end()),
+		std::vector<uint32_t>(terrain_options, terrain_options + header->terrain_count),
+		std::vector<uint32_t>(rail_options, rail_options + header->rail_count),
+	};
+
+	_rules.storage = file;
+	return _rules;
+}
+
+bool WaveFunctionCollapse::write_rule_pack(const RuleSet& rules, std::string filepath) {
+	std::ofstream file(filepath, std::ios::binary);
+	if (file.fail()) {
+		printf("Unable to open %s for writing!\n", filepath.c_str());
+		return false;
+	}
+
+	RulePackHeader header{};
+	header.magic = RULE_PACK_MAGIC;
+	header.version = RULE_PACK_VERSION;
+	header.word_count = OptionSet::WORD_COUNT;
+	header.option_count = static_cast<uint32_t>(rules.option_values.size());
+	header.option_indices_size = static_cast<uint32_t>(rules.option_indices.size());
+	header.terrain_count = static_cast<uint32_t>(rules.options.terrain.size());
+	header.rail_count = static_cast<uint32_t>(rules.options.rail.size());
+	header.byte_order = RULE_PACK_BYTE_ORDER;
+
+	auto write_table = [&file](const auto& table) {
+		file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(table[0]));
+	};
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	write_table(rules.valid_options_lookup);
+	write_table(rules.option_values);
+	write_table(rules.relative_frequencies);
+	write_table(rules.weight_log_weights);
+	write_table(rules.option_indices);
+	write_table(rules.options.terrain);
+	write_table(rules.options.rail);
+
+	if (file.fail()) {
+		printf("Unable to write to %s!\n", filepath.c_str());
+		return false;
+	}
+
+	printf("Written to %s\n", filepath.c_str());
+	return true;
+}
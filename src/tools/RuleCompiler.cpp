@@ -0,0 +1,125 @@
+// Compiles the JSON terrain generation rules, either into a rule pack which the game can memory-map instead of parsing the JSON,
+// or into a header of constexpr tables which the solver can be instantiated over (see BasicWaveFunctionCollapse)
+// Usage: rule_compiler <input.json> <output.rules|output.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "WaveFunctionCollapse.hpp"
+
+const std::string HEADER_EXTENSION = ".hpp";
+
+void write_values(FILE* file, std::span<const uint32_t> values) {
+	for (uint32_t i = 0; i < values.size(); i++) {
+		if (values[i] == WFC::NO_OPTION) fprintf(file, "%sWFC::NO_OPTION", i ? ", " : "");
+		else fprintf(file, "%s%u", i ? ", " : "", values[i]);
+	}
+}
+
+// Writes the option set using only as many words as the compiled rules need
+void write_option_set(FILE* file, const WaveFunctionCollapse::OptionSet& options, uint32_t word_count) {
+	std::vector<uint64_t> words(word_count, 0);
+	for (uint32_t index = options.first(); index != WaveFunctionCollapse::OptionSet::NONE; index = options.next(index)) {
+		words[index / WaveFunctionCollapse::OptionSet::WORD_SIZE] |= 1ULL << (index % WaveFunctionCollapse::OptionSet::WORD_SIZE);
+	}
+
+	fprintf(file, "OptionSet({ ");
+	for (uint32_t i = 0; i < word_count; i++) {
+		fprintf(file, "%s0x%016llxULL", i ? ", " : "", static_cast<unsigned long long>(words[i]));
+	}
+	fprintf(file, " })");
+}
+
+bool write_rule_header(const WaveFunctionCollapse::RuleSet& rules, std::string input_filepath, std::string filepath) {
+	FILE* file = fopen(filepath.c_str(), "w");
+	if (!file) {
+		printf("Unable to open %s for writing!\n", filepath.c_str());
+		return false;
+	}
+
+	uint32_t option_count = static_cast<uint32_t>(rules.option_values.size());
+	uint32_t word_count = (option_count + WaveFunctionCollapse::OptionSet::WORD_SIZE - 1) / WaveFunctionCollapse::OptionSet::WORD_SIZE;
+
+	fprintf(file, "// Generated from %s by the rule compiler: do not edit\n\n", std::filesystem::path(input_filepath).filename().string().c_str());
+	fprintf(file, "#pragma once\n\n");
+	fprintf(file, "#include \"WaveFunctionCollapse.hpp\"\n\n");
+	fprintf(file, "struct CompiledTerrainRules {\n");
+	fprintf(file, "\tstatic constexpr uint32_t OPTION_COUNT = %u;\n", option_count);
+	fprintf(file, "\ttypedef WFC::OptionBitset<OPTION_COUNT> OptionSet;\n\n");
+
+	fprintf(file, "\tstatic constexpr std::array<uint32_t, OPTION_COUNT> option_values = { ");
+	write_values(file, rules.option_values);
+	fprintf(file, " };\n");
+
+	fprintf(file, "\tstatic constexpr std::array<uint32_t, OPTION_COUNT> relative_frequencies = { ");
+	write_values(file, rules.relative_frequencies);
+	fprintf(file, " };\n");
+
+	// Hex floats, so that the values are exactly the same as the runtime rules
+	fprintf(file, "\tstatic constexpr std::array<float, OPTION_COUNT> weight_log_weights = { ");
+	for (uint32_t i = 0; i < option_count; i++) {
+		fprintf(file, "%s%af", i ? ", " : "", rules.weight_log_weights[i]);
+	}
+	fprintf(file, " };\n\n");
+
+	fprintf(file, "\tstatic constexpr std::array<std::array<OptionSet, WFC::DIRECTION_COUNT>, OPTION_COUNT> valid_options_lookup = { {\n");
+	for (uint32_t index = 0; index < option_count; index++) {
+		fprintf(file, "\t\t{ { ");
+		for (uint8_t i = 0; i < WFC::DIRECTION_COUNT; i++) {
+			if (i) fprintf(file, ", ");
+			write_option_set(file, rules.valid_options_lookup[index][i], word_count);
+		}
+		fprintf(file, " } }, // %u\n", rules.option_values[index]);
+	}
+	fprintf(file, "\t} };\n\n");
+
+	fprintf(file, "\tstatic constexpr std::array<uint32_t, %zu> option_indices = { ", rules.option_indices.size());
+	write_values(file, rules.option_indices);
+	fprintf(file, " };\n\n");
+
+	fprintf(file, "\tWFC::OptionCollections options = {\n\t\t{ ");
+	write_values(file, rules.options.all);
+	fprintf(file, " },\n\t\t{ ");
+	write_values(file, rules.options.terrain);
+	fprintf(file, " },\n\t\t{ ");
+	write_values(file, rules.options.rail);
+	fprintf(file, " },\n\t};\n");
+	fprintf(file, "};\n");
+
+	bool failed = ferror(file);
+	fclose(file);
+
+	if (failed) {
+		printf("Unable to write to %s!\n", filepath.c_str());
+		return false;
+	}
+
+	printf("Written to %s\n", filepath.c_str());
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc != 3) {
+		printf("Usage: %s <input.json> <output.rules|output.hpp>\n", argv[0]);
+		return 1;
+	}
+
+	try {
+		WaveFunctionCollapse::RuleSet rules = WaveFunctionCollapse::load_rules(argv[1]);
+
+		if (std::filesystem::path(argv[2]).extension() == HEADER_EXTENSION) {
+			if (!write_rule_header(rules, argv[1], argv[2])) return 1;
+		}
+		else {
+			if (!WaveFunctionCollapse::write_rule_pack(rules, argv[2])) return 1;
+		}
+
+		printf("Compiled %zu options\n", rules.option_values.size());
+	}
+	catch (const std::exception& error) {
+		printf("Unable to compile %s: %s\n", argv[1], error.what());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+// Generates chunks the same way the game does, but without SDL, and reports how long the terrain generation takes
+// Usage: wfc_benchmark [rules.json|rules.rules] [seed count] [chunks per seed]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+#include "ChunkGenerator.hpp"
+
+const uint32_t DEFAULT_SEED_COUNT = 50;
+const uint32_t DEFAULT_CHUNKS_PER_SEED = 100;
+
+typedef std::chrono::steady_clock Clock;
+
+// Time taken, in microseconds
+double elapsed_us(Clock::time_point start) {
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+void print_latencies(const char* name, std::vector<double>& latencies) {
+	if (latencies.empty()) return;
+
+	std::sort(latencies.begin(), latencies.end());
+
+	auto percentile = [&latencies](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+	printf("%-8s p50: %9.1f us   p99: %9.1f us   max: %9.1f us\n", name, percentile(0.5), percentile(0.99), latencies.back());
+}
+
+int main(int argc, char* argv[]) {
+	std::string rules_path = PATHS::LEVEL_DATA::LOCATION + PATHS::LEVEL_DATA::TERRAIN_GENERATION_DATA;
+	uint32_t seed_count = DEFAULT_SEED_COUNT;
+	uint32_t chunks_per_seed = DEFAULT_CHUNKS_PER_SEED;
+
+	if (argc > 4) {
+		printf("Usage: %s [rules.json|rules.rules] [seed count] [chunks per seed]\n", argv[0]);
+		return 1;
+	}
+
+	try {
+		if (argc > 1) rules_path = argv[1];
+		if (argc > 2) seed_count = std::stoul(argv[2]);
+		if (argc > 3) chunks_per_seed = std::stoul(argv[3]);
+	}
+	catch (const std::exception& error) {
+		printf("Invalid argument: %s\n", error.what());
+		return 1;
+	}
+
+	TerrainRules terrain_rules;
+	try {
+#ifdef COMPILED_TERRAIN_RULES
+		printf("Using rules compiled into the benchmark\n");
+#else
+		terrain_rules = WaveFunctionCollapse::load_rules(rules_path);
+		printf("Using rules from %s\n", rules_path.c_str());
+#endif
+	}
+	catch (const std::exception& error) {
+		printf("Unable to load %s: %s\n", rules_path.c_str(), error.what());
+		return 1;
+	}
+
+	std::vector<double> plan_latencies, chunk_latencies;
+	plan_latencies.reserve(seed_count * chunks_per_seed);
+	chunk_latencies.reserve(seed_count * chunks_per_seed);
+
+	uint64_t decisions = 0, backtracks = 0, restarts = 0, retried = 0, failed = 0;
+	double total_us = 0.0;
+
+	for (uint32_t seed = 0; seed < seed_count; seed++) {
+		ChunkGenerator chunk_generator(terrain_rules, seed);
+		std::unique_ptr<ChunkGenerator::TerrainSolver> solver = chunk_generator.create_terrain_solver();
+
+		for (uint32_t i = 0; i < chunks_per_seed; i++) {
+			Clock::time_point start = Clock::now();
+			ChunkGenerator::ChunkPlan plan = chunk_generator.plan_next_chunk();
+			plan_latencies.push_back(elapsed_us(start));
+
+			start = Clock::now();
+			ChunkGenerator::Chunk chunk = chunk_generator.generate_chunk(plan, *solver);
+			chunk_latencies.push_back(elapsed_us(start));
+
+			total_us += plan_latencies.back() + chunk_latencies.back();
+
+			const ChunkGenerator::ChunkStatistics& statistics = chunk.statistics;
+			decisions += statistics.solver.decisions;
+			backtracks += statistics.solver.backtracks;
+			restarts += statistics.solver.restarts;
+			if (statistics.attempts > 1) retried++;
+			if (!statistics.complete) failed++;
+		}
+	}
+
+	uint64_t chunk_count = chunk_latencies.size();
+	if (chunk_count == 0) {
+		printf("No chunks generated\n");
+		return 0;
+	}
+
+	printf("Generated %llu chunks (%u seeds x %u chunks) in %.3f s\n", static_cast<unsigned long long>(chunk_count), seed_count, chunks_per_seed, total_us / 1e6);
+	printf("%.1f chunks/sec\n\n", chunk_count / (total_us / 1e6));
+
+	print_latencies("Plan", plan_latencies);
+	print_latencies("Terrain", chunk_latencies);
+
+	printf("\nDecisions:  %llu (%.1f per chunk)\n", static_cast<unsigned long long>(decisions), static_cast<double>(decisions) / chunk_count);
+	printf("Backtracks: %llu (%.1f per chunk)\n", static_cast<unsigned long long>(backtracks), static_cast<double>(backtracks) / chunk_count);
+	printf("Restarts:   %llu (%.3f per chunk)\n", static_cast<unsigned long long>(restarts), static_cast<double>(restarts) / chunk_count);
+	printf("Retried:    %llu chunks (%.2f%%)\n", static_cast<unsigned long long>(retried), 100.0 * retried / chunk_count);
+	printf("Failed:     %llu chunks (%.2f%%)\n", static_cast<unsigned long long>(failed), 100.0 * failed / chunk_count);
+
+	return 0;
+}